@@ -1,11 +1,152 @@
 #include "BroadcastRecv.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include "CHIRP/protocol_info.hpp"
 
+#ifdef CHIRP_IO_URING
+#include "CHIRP/IoUring.hpp"
+#else
+// Never instantiated if built without io_uring support
+class cnstln::CHIRP::IoUringRecv {};
+#endif
+
 using namespace cnstln::CHIRP;
 
 constexpr std::size_t MESSAGE_BUFFER = 1024;
 
+// Maximum number of messages received per system call
+constexpr std::size_t RECV_BATCH = 64;
+
+namespace {
+    // Memory block for a single async handler, avoids a heap allocation per asynchronous operation
+    class HandlerMemory {
+    public:
+        void* allocate(std::size_t size) {
+            if (!in_use_ && size <= storage_.size()) {
+                in_use_ = true;
+                return storage_.data();
+            }
+            return ::operator new(size);
+        }
+
+        void deallocate(void* pointer) {
+            if (pointer == storage_.data()) {
+                in_use_ = false;
+            }
+            else {
+                ::operator delete(pointer);
+            }
+        }
+
+    private:
+        alignas(std::max_align_t) std::array<std::byte, 256> storage_ {};
+        bool in_use_ {false};
+    };
+
+    // Allocator for async handlers using the handler memory block
+    template <typename T>
+    class HandlerAllocator {
+    public:
+        using value_type = T;
+
+        explicit HandlerAllocator(HandlerMemory& memory) : memory_(&memory) {}
+
+        template <typename U>
+        HandlerAllocator(const HandlerAllocator<U>& other) noexcept : memory_(other.memory_) {}
+
+        T* allocate(std::size_t n) { return static_cast<T*>(memory_->allocate(sizeof(T) * n)); }
+
+        void deallocate(T* pointer, std::size_t) { memory_->deallocate(pointer); }
+
+        bool operator==(const HandlerAllocator& other) const noexcept { return memory_ == other.memory_; }
+
+    private:
+        template <typename> friend class HandlerAllocator;
+        HandlerMemory* memory_;
+    };
+
+    // Handler for waiting until the socket is readable
+    struct WaitHandler {
+        using allocator_type = HandlerAllocator<WaitHandler>;
+
+        bool* readable;
+        HandlerMemory* memory;
+
+        allocator_type get_allocator() const noexcept { return allocator_type(*memory); }
+
+        void operator()(const asio::error_code& error) const { *readable = !error; }
+    };
+
+    // Each thread waits for at most one socket at once
+    thread_local HandlerMemory wait_handler_memory {};
+
+#ifdef __linux__
+    // Information reported by the kernel alongside a received message
+    struct ControlInfo {
+        std::optional<std::chrono::system_clock::time_point> timestamp;
+        unsigned int interface_index;
+        std::optional<std::uint32_t> drops;
+    };
+
+    // Read drop counter, kernel receive timestamp and interface index from the control messages of a received message
+    ControlInfo ReadControlMessages(msghdr& msg_header) {
+        ControlInfo info {};
+        for (auto* cmsg = CMSG_FIRSTHDR(&msg_header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg_header, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+                in_pktinfo pktinfo {};
+                std::memcpy(&pktinfo, CMSG_DATA(cmsg), sizeof(pktinfo));
+                info.interface_index = static_cast<unsigned int>(pktinfo.ipi_ifindex);
+                continue;
+            }
+            if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+                in6_pktinfo pktinfo {};
+                std::memcpy(&pktinfo, CMSG_DATA(cmsg), sizeof(pktinfo));
+                info.interface_index = pktinfo.ipi6_ifindex;
+                continue;
+            }
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                // Total number of dropped messages of the socket
+                std::uint32_t drops {};
+                std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                info.drops = drops;
+            }
+            else if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                // Kernel receive time in system clock
+                timespec time {};
+                std::memcpy(&time, CMSG_DATA(cmsg), sizeof(time));
+                const auto since_epoch = std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+                info.timestamp = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(since_epoch));
+            }
+        }
+        return info;
+    }
+#endif
+}
+
+#ifdef __linux__
+// Size of the control message buffer for each received message (drop counter, timestamp and packet information)
+constexpr std::size_t CONTROL_BUFFER_SIZE =
+    CMSG_SPACE(sizeof(std::uint32_t)) + CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(in6_pktinfo));
+#endif
+
 std::string BroadcastMessage::content_to_string() const {
     std::string ret;
     ret.resize(content.size());
@@ -15,24 +156,64 @@ std::string BroadcastMessage::content_to_string() const {
     return ret;
 }
 
-BroadcastRecv::BroadcastRecv(asio::ip::address any_address)
+BroadcastRecv::BroadcastRecv(asio::ip::address any_address, bool reuse_port)
   : io_context_(), endpoint_(std::move(any_address), asio::ip::port_type(CHIRP_PORT)),
     socket_(io_context_, endpoint_.protocol()) {
+    Open(reuse_port);
+}
+
+BroadcastRecv::BroadcastRecv(std::string_view any_ip)
+  : BroadcastRecv(asio::ip::make_address(any_ip)) {}
+
+BroadcastRecv::~BroadcastRecv() = default;
+
+BroadcastRecv::BroadcastRecv(asio::any_io_executor executor, asio::ip::address any_address, bool reuse_port)
+  : io_context_(), endpoint_(std::move(any_address), asio::ip::port_type(CHIRP_PORT)),
+    socket_(std::move(executor), endpoint_.protocol()) {
+    Open(reuse_port);
+}
+
+void BroadcastRecv::Open(bool reuse_port) {
     // Set reuseable address socket option
     socket_.set_option(asio::socket_base::reuse_address(true));
+#ifdef SO_REUSEPORT
+    // Set reuseable port socket option to share incoming broadcasts between sockets
+    if (reuse_port) {
+        socket_.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+    }
+#else
+    static_cast<void>(reuse_port);
+#endif
+#ifdef SO_RXQ_OVFL
+    // Report number of dropped messages alongside received messages
+    socket_.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_RXQ_OVFL>(true));
+#endif
     // Bind socket on receiving side
     socket_.bind(endpoint_);
 }
 
-BroadcastRecv::BroadcastRecv(std::string_view any_ip)
-  : BroadcastRecv(asio::ip::make_address(any_ip)) {}
-
 BroadcastMessage BroadcastRecv::RecvBroadcast() {
     BroadcastMessage message {};
 
     // Reserve some space for message
     message.content.resize(MESSAGE_BUFFER);
 
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        // Wait until a message fitting into the buffer is received
+        std::array<BroadcastBuffer, 1> buffers {};
+        buffers[0].buffer = message.content;
+        do {
+            io_uring_->Wait();
+        } while (DrainBroadcasts(buffers) == 0);
+        message.address = buffers[0].address;
+        message.timestamp = buffers[0].timestamp;
+        message.interface_index = buffers[0].interface_index;
+        message.content.resize(buffers[0].length);
+        return message;
+    }
+#endif
+
     // Receive content and length of message
     asio::ip::udp::endpoint sender_endpoint {};
     auto length = socket_.receive_from(asio::buffer(message.content), sender_endpoint);
@@ -47,25 +228,586 @@ BroadcastMessage BroadcastRecv::RecvBroadcast() {
 }
 
 std::optional<BroadcastMessage> BroadcastRecv::AsyncRecvBroadcast(std::chrono::steady_clock::duration timeout) {
+    // Receive single message via batched receive, avoids a future for each receive operation
+    std::array<BroadcastMessage, 1> messages {};
+    if (AsyncRecvBroadcasts(messages, timeout) == 0) {
+        return std::nullopt;
+    }
+    return std::move(messages[0]);
+}
+
+std::size_t BroadcastRecv::AsyncRecvBroadcasts(std::span<BroadcastMessage> messages, std::chrono::steady_clock::duration timeout) {
+    if (messages.empty() || !WaitBroadcast(timeout)) {
+        return 0;
+    }
+
+    std::size_t received = 0;
+    while (received < messages.size()) {
+        const auto batch = std::min(messages.size() - received, RECV_BATCH);
+
+        // Reference the content of the caller-owned messages as buffers
+        std::array<BroadcastBuffer, RECV_BATCH> buffers {};
+        for (std::size_t n = 0; n < batch; ++n) {
+            auto& content = messages[received + n].content;
+            content.resize(MESSAGE_BUFFER);
+            buffers[n].buffer = content;
+        }
+
+        const auto batch_received = DrainBroadcasts(std::span(buffers).first(batch));
+
+        for (std::size_t n = 0; n < batch_received; ++n) {
+            auto& message = messages[received + n];
+            message.address = buffers[n].address;
+            message.timestamp = buffers[n].timestamp;
+            message.interface_index = buffers[n].interface_index;
+            message.content.resize(buffers[n].length);
+        }
+        received += batch_received;
+
+        // Stop if socket queue is drained
+        if (batch_received < batch) {
+            break;
+        }
+    }
+
+    return received;
+}
+
+std::size_t BroadcastRecv::AsyncRecvBroadcasts(std::span<BroadcastBuffer> buffers, std::chrono::steady_clock::duration timeout) {
+    if (buffers.empty() || !WaitBroadcast(timeout)) {
+        return 0;
+    }
+    return DrainBroadcasts(buffers);
+}
+
+asio::awaitable<BroadcastMessage> BroadcastRecv::AwaitRecvBroadcast() {
     BroadcastMessage message {};
+
+    // Reserve some space for message
     message.content.resize(MESSAGE_BUFFER);
+
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        // Receive via buffer ring into content
+        std::array<BroadcastBuffer, 1> buffers {};
+        buffers[0].buffer = message.content;
+        co_await AwaitRecvBroadcasts(buffers);
+        message.address = buffers[0].address;
+        message.timestamp = buffers[0].timestamp;
+        message.interface_index = buffers[0].interface_index;
+        message.content.resize(buffers[0].length);
+        co_return message;
+    }
+#endif
+
+    // Receive content and length of message
     asio::ip::udp::endpoint sender_endpoint {};
+    const auto length = co_await socket_.async_receive_from(asio::buffer(message.content), sender_endpoint, asio::use_awaitable);
+
+    // Store IP address
+    message.address = sender_endpoint.address();
+
+    // Resize content to actual message length
+    message.content.resize(length);
+
+    co_return message;
+}
+
+asio::awaitable<std::size_t> BroadcastRecv::AwaitRecvBroadcasts(std::span<BroadcastBuffer> buffers) {
+    if (buffers.empty()) {
+        co_return 0;
+    }
+    while (true) {
+#ifdef CHIRP_IO_URING
+        if (io_uring_) {
+            co_await io_uring_->AsyncWait(asio::use_awaitable);
+        }
+        else {
+            co_await socket_.async_wait(asio::socket_base::wait_read, asio::use_awaitable);
+        }
+#else
+        co_await socket_.async_wait(asio::socket_base::wait_read, asio::use_awaitable);
+#endif
+        // Wait again if all queued messages were rejected
+        const auto received = DrainBroadcasts(buffers);
+        if (received > 0) {
+            co_return received;
+        }
+    }
+}
+
+void BroadcastRecv::Cancel() {
+    asio::post(socket_.get_executor(), [this]() {
+        socket_.cancel();
+#ifdef CHIRP_IO_URING
+        if (io_uring_) {
+            io_uring_->Cancel();
+        }
+#endif
+    });
+}
+
+void BroadcastRecv::StartRecvBroadcasts(std::span<BroadcastBuffer> buffers, std::function<void(std::size_t)> handler) {
+    recv_buffers_ = buffers;
+    recv_handler_ = std::move(handler);
+
+    // Restart IO context here and not in Run() such that Stop() can be called before Run()
+    io_context_.restart();
+    ContinueRecvBroadcasts();
+}
+
+void BroadcastRecv::Run() {
+    // Run IO context until stopped, waiting for messages does not require any wakeups
+    io_context_.run();
+
+    // Cancel receive chain and run its handler to release the buffers
+    socket_.cancel();
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        io_uring_->Cancel();
+    }
+#endif
+    io_context_.restart();
+    io_context_.poll();
+}
+
+void BroadcastRecv::Stop() {
+    io_context_.stop();
+}
+
+void BroadcastRecv::ContinueRecvBroadcasts() {
+    auto handler = [this](const asio::error_code& error) {
+        // Receive chain cancelled
+        if (error) {
+            return;
+        }
+        const auto received = DrainBroadcasts(recv_buffers_);
+        if (received > 0) {
+            recv_handler_(received);
+        }
+        ContinueRecvBroadcasts();
+    };
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        io_uring_->AsyncWait(std::move(handler));
+        return;
+    }
+#endif
+    socket_.async_wait(asio::socket_base::wait_read, std::move(handler));
+}
+
+void BroadcastRecv::SetReceiveBufferSize(std::size_t size) {
+    socket_.set_option(asio::socket_base::receive_buffer_size(static_cast<int>(size)));
+}
+
+std::size_t BroadcastRecv::GetReceiveBufferSize() const {
+    asio::socket_base::receive_buffer_size option {};
+    socket_.get_option(option);
+    return static_cast<std::size_t>(option.value());
+}
+
+BroadcastRecvStats BroadcastRecv::GetStats() const {
+    auto syscalls = syscalls_.load(std::memory_order_relaxed);
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        syscalls += io_uring_->GetSyscalls();
+    }
+#endif
+    return {kernel_drops_.load(std::memory_order_relaxed),
+            filter_drops_.load(std::memory_order_relaxed),
+            oversized_.load(std::memory_order_relaxed),
+            syscalls};
+}
+
+void BroadcastRecv::RecordDrops(std::uint32_t drops) {
+    // Counter reported by the kernel wraps around
+    const auto new_drops = static_cast<std::uint32_t>(drops - std::exchange(reported_drops_, drops));
+    if (new_drops == 0) {
+        return;
+    }
+    // Drops rejected by the filter cannot be told apart from drops since the receive buffer was full
+    auto& counter = filter_attached_.load(std::memory_order_relaxed) ? filter_drops_ : kernel_drops_;
+    counter.fetch_add(new_drops, std::memory_order_relaxed);
+}
+
+bool BroadcastRecv::EnableIoUring() {
+#ifdef CHIRP_IO_URING
+    if (!io_uring_) {
+        try {
+            io_uring_ = std::make_unique<IoUringRecv>(socket_, MESSAGE_BUFFER, CONTROL_BUFFER_SIZE);
+        }
+        catch (const std::system_error&) {
+            // Kernel does not support io_uring or multishot receive operations
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void BroadcastRecv::JoinMulticastGroup(const asio::ip::address& multicast_address) {
+    // Only receive multicasts of groups joined by this socket
+    if (multicast_address.is_v4()) {
+#ifdef IP_MULTICAST_ALL
+        socket_.set_option(asio::detail::socket_option::boolean<IPPROTO_IP, IP_MULTICAST_ALL>(false));
+#endif
+    }
+    else {
+#ifdef IPV6_MULTICAST_ALL
+        socket_.set_option(asio::detail::socket_option::boolean<IPPROTO_IPV6, IPV6_MULTICAST_ALL>(false));
+#endif
+    }
+    // Interface for IPv6 is given by scope ID of the address
+    socket_.set_option(asio::ip::multicast::join_group(multicast_address));
+}
+
+#ifdef SO_TIMESTAMPNS
+
+bool BroadcastRecv::EnableTimestamps() {
+    asio::error_code error {};
+    socket_.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_TIMESTAMPNS>(true), error);
+    return !error;
+}
+
+#else
+
+bool BroadcastRecv::EnableTimestamps() {
+    // No kernel receive timestamps available
+    return false;
+}
+
+#endif
+
+#ifdef __linux__
+
+bool BroadcastRecv::EnablePacketInfo() {
+    asio::error_code error {};
+    if (endpoint_.address().is_v4()) {
+        socket_.set_option(asio::detail::socket_option::boolean<IPPROTO_IP, IP_PKTINFO>(true), error);
+    }
+    else {
+        socket_.set_option(asio::detail::socket_option::boolean<IPPROTO_IPV6, IPV6_RECVPKTINFO>(true), error);
+    }
+    return !error;
+}
+
+#else
+
+bool BroadcastRecv::EnablePacketInfo() {
+    // No packet information available
+    return false;
+}
+
+#endif
+
+bool BroadcastRecv::AttachFilter(std::size_t length, const std::vector<BroadcastFilterPattern>& patterns) {
+    filter_length_ = length;
+    filter_patterns_ = patterns;
+    return UpdateFilter();
+}
+
+void BroadcastRecv::DetachFilter() {
+    filter_length_ = 0;
+    filter_patterns_.clear();
+    UpdateFilter();
+}
+
+#ifdef __linux__
+
+bool BroadcastRecv::SetShard(std::size_t offset, std::size_t index, std::size_t count) {
+    if (count == 0 || index >= count) {
+        return false;
+    }
+    shard_offset_ = offset;
+    shard_index_ = index;
+    shard_count_ = count;
+    if (count > 1) {
+        // Direct unicast messages to the socket with the same index in the reuse port group
+        const auto shard_offset = static_cast<std::uint32_t>(offset);
+        const auto shard_count = static_cast<std::uint32_t>(count);
+        std::array<sock_filter, 3> select_program {{
+            BPF_STMT(BPF_LD | BPF_B | BPF_ABS, shard_offset),
+            BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, shard_count),
+            BPF_STMT(BPF_RET | BPF_A, 0),
+        }};
+        const sock_fprog select_filter {static_cast<unsigned short>(select_program.size()), select_program.data()};
+        if (::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &select_filter, sizeof(select_filter)) != 0) {
+            shard_count_ = 1;
+            UpdateFilter();
+            return false;
+        }
+    }
+    return UpdateFilter();
+}
+
+bool BroadcastRecv::UpdateFilter() {
+    if (filter_length_ == 0 && filter_patterns_.empty() && shard_count_ <= 1) {
+        int dummy = 0;
+        ::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof(dummy));
+        filter_attached_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    // For UDP sockets the filter sees the UDP header in front of the message
+    constexpr std::uint32_t UDP_HEADER_LENGTH = 8;
+
+    // Instructions until the final accept and drop instructions, conditional jumps to drop are resolved afterwards
+    std::vector<sock_filter> program {};
+    std::vector<std::size_t> drop_jumps {};
+    const auto add_compare = [&](std::uint16_t load_code, std::uint32_t offset, std::uint32_t value) {
+        program.push_back(BPF_STMT(load_code, offset));
+        drop_jumps.push_back(program.size());
+        program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, value, 0, 0));
+    };
+
+    // Check share of this receiver
+    if (shard_count_ > 1) {
+        program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, UDP_HEADER_LENGTH + static_cast<std::uint32_t>(shard_offset_)));
+        program.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<std::uint32_t>(shard_count_)));
+        drop_jumps.push_back(program.size());
+        program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<std::uint32_t>(shard_index_), 0, 0));
+    }
+
+    // Check length
+    if (filter_length_ > 0) {
+        add_compare(BPF_LD | BPF_W | BPF_LEN, 0, UDP_HEADER_LENGTH + static_cast<std::uint32_t>(filter_length_));
+    }
+
+    // Check patterns in chunks of four, two or one bytes (loaded in network byte order)
+    for (const auto& pattern : filter_patterns_) {
+        std::size_t n = 0;
+        while (n < pattern.bytes.size()) {
+            const auto offset = UDP_HEADER_LENGTH + static_cast<std::uint32_t>(pattern.offset + n);
+            const auto remaining = pattern.bytes.size() - n;
+            const auto* bytes = &pattern.bytes[n];
+            if (remaining >= 4) {
+                const auto value = (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) |
+                                   (static_cast<std::uint32_t>(bytes[2]) << 8) | bytes[3];
+                add_compare(BPF_LD | BPF_W | BPF_ABS, offset, value);
+                n += 4;
+            }
+            else if (remaining >= 2) {
+                const auto value = (static_cast<std::uint32_t>(bytes[0]) << 8) | bytes[1];
+                add_compare(BPF_LD | BPF_H | BPF_ABS, offset, value);
+                n += 2;
+            }
+            else {
+                add_compare(BPF_LD | BPF_B | BPF_ABS, offset, bytes[0]);
+                n += 1;
+            }
+        }
+    }
+
+    // Accept whole message, otherwise drop
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF));
+    const auto drop_index = program.size();
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
 
-    // Receive as future
-    auto length_future = socket_.async_receive_from(asio::buffer(message.content), sender_endpoint, asio::use_future);
+    // Resolve jumps to drop instruction, which are relative and limited to 8 bits
+    for (const auto jump_index : drop_jumps) {
+        const auto jump_offset = drop_index - jump_index - 1;
+        if (jump_offset > 0xFF) {
+            return false;
+        }
+        program[jump_index].jf = static_cast<std::uint8_t>(jump_offset);
+    }
+
+    const sock_fprog filter {static_cast<unsigned short>(program.size()), program.data()};
+    if (::setsockopt(socket_.native_handle(), SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) != 0) {
+        return false;
+    }
+    filter_attached_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+#else
 
-    // Run IO context for timeout
+bool BroadcastRecv::SetShard(std::size_t /*offset*/, std::size_t /*index*/, std::size_t count) {
+    // No kernel-level filtering available, thus only a single receiver is supported
+    return count == 1;
+}
+
+bool BroadcastRecv::UpdateFilter() {
+    // No kernel-level filtering available
+    return filter_length_ == 0 && filter_patterns_.empty();
+}
+
+#endif
+
+bool BroadcastRecv::WaitBroadcast(std::chrono::steady_clock::duration timeout) {
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        return io_uring_->Wait(timeout);
+    }
+#endif
+
+    // Wait until socket is readable
+    bool readable = false;
+    socket_.async_wait(asio::socket_base::wait_read, WaitHandler {&readable, &wait_handler_memory});
+
+    // Run IO context for timeout, which waits via a single system call
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
     io_context_.restart();
     io_context_.run_for(timeout);
 
     // If IO context not stopped, then no message received
     if (!io_context_.stopped()) {
-        // Cancel async operations
+        // Cancel async operations and run handler since it references the stack
         socket_.cancel();
-        return std::nullopt;
+        io_context_.restart();
+        io_context_.run();
+        return false;
     }
 
-    message.address = sender_endpoint.address();
-    message.content.resize(length_future.get());
-    return message;
+    return readable;
+}
+
+#ifdef __linux__
+
+std::size_t BroadcastRecv::DrainBroadcasts(std::span<BroadcastBuffer> buffers) {
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        // Take messages already received into the buffer ring
+        std::size_t received = 0;
+        IoUringRecv::Message message {};
+        while (received < buffers.size() && io_uring_->Next(message)) {
+            const auto info = ReadControlMessages(message.header);
+            if (info.drops.has_value()) {
+                RecordDrops(info.drops.value());
+            }
+            auto& buffer = buffers[received];
+            if ((message.header.msg_flags & MSG_TRUNC) != 0 || message.payload.size() > buffer.buffer.size()) {
+                oversized_.fetch_add(1, std::memory_order_relaxed);
+                io_uring_->Recycle(message);
+                continue;
+            }
+            std::ranges::copy(message.payload, buffer.buffer.begin());
+            asio::ip::udp::endpoint sender_endpoint {};
+            std::memcpy(sender_endpoint.data(), message.header.msg_name, message.header.msg_namelen);
+            sender_endpoint.resize(message.header.msg_namelen);
+            buffer.address = sender_endpoint.address();
+            buffer.timestamp = info.timestamp;
+            buffer.interface_index = info.interface_index;
+            buffer.length = message.payload.size();
+            io_uring_->Recycle(message);
+            ++received;
+        }
+        return received;
+    }
+#endif
+
+    std::array<mmsghdr, RECV_BATCH> msg_headers {};
+    std::array<iovec, RECV_BATCH> iovecs {};
+    std::array<asio::ip::udp::endpoint, RECV_BATCH> sender_endpoints {};
+    struct alignas(cmsghdr) ControlBuffer {
+        std::array<std::byte, CONTROL_BUFFER_SIZE> data;
+    };
+    std::array<ControlBuffer, RECV_BATCH> control_buffers {};
+
+    std::size_t received = 0;
+    while (received < buffers.size()) {
+        const auto batch = std::min(buffers.size() - received, RECV_BATCH);
+
+        // Prepare message headers pointing to the caller-provided storage. Messages are moved forward to earlier buffers
+        // if oversized messages are skipped, thus each buffer is limited to the smallest size of the buffers before it
+        // such that every message accepted by the kernel fits wherever it is moved to.
+        std::size_t max_length = std::numeric_limits<std::size_t>::max();
+        for (std::size_t n = 0; n < batch; ++n) {
+            auto& buffer = buffers[received + n].buffer;
+            max_length = std::min(max_length, buffer.size());
+            iovecs[n] = {buffer.data(), max_length};
+            msg_headers[n] = {};
+            msg_headers[n].msg_hdr.msg_name = sender_endpoints[n].data();
+            msg_headers[n].msg_hdr.msg_namelen = static_cast<socklen_t>(sender_endpoints[n].capacity());
+            msg_headers[n].msg_hdr.msg_iov = &iovecs[n];
+            msg_headers[n].msg_hdr.msg_iovlen = 1;
+            msg_headers[n].msg_hdr.msg_control = control_buffers[n].data.data();
+            msg_headers[n].msg_hdr.msg_controllen = CONTROL_BUFFER_SIZE;
+        }
+
+        // Receive all queued messages in a single system call
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        const auto ret = ::recvmmsg(socket_.native_handle(), msg_headers.data(), static_cast<unsigned int>(batch), MSG_DONTWAIT, nullptr);
+        const auto batch_received = ret > 0 ? static_cast<std::size_t>(ret) : 0;
+
+        // Store received messages consecutively, skipping messages that did not fit in their buffer
+        const auto batch_begin = received;
+        for (std::size_t n = 0; n < batch_received; ++n) {
+            auto& msg_header = msg_headers[n].msg_hdr;
+
+            const auto info = ReadControlMessages(msg_header);
+            if (info.drops.has_value()) {
+                RecordDrops(info.drops.value());
+            }
+
+            // Kernel truncates messages longer than the buffer they were received into
+            const auto length = static_cast<std::size_t>(msg_headers[n].msg_len);
+            if ((msg_header.msg_flags & MSG_TRUNC) != 0) {
+                oversized_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            auto& buffer = buffers[received];
+            if (received != batch_begin + n) {
+                std::copy_n(buffers[batch_begin + n].buffer.data(), length, buffer.buffer.data());
+            }
+            sender_endpoints[n].resize(msg_headers[n].msg_hdr.msg_namelen);
+            buffer.address = sender_endpoints[n].address();
+            buffer.timestamp = info.timestamp;
+            buffer.interface_index = info.interface_index;
+            buffer.length = length;
+            ++received;
+        }
+
+        // Stop if socket queue is drained
+        if (batch_received < batch) {
+            break;
+        }
+    }
+
+    return received;
 }
+
+#else
+
+std::size_t BroadcastRecv::DrainBroadcasts(std::span<BroadcastBuffer> buffers) {
+    // Switch to non-blocking mode to stop once the socket queue is drained
+    socket_.non_blocking(true);
+
+    // Additional byte after the buffer to detect oversized messages
+    std::uint8_t overflow_byte {};
+
+    std::size_t received = 0;
+    while (received < buffers.size()) {
+        auto& buffer = buffers[received];
+        const std::array<asio::mutable_buffer, 2> scatter_buffers {asio::buffer(buffer.buffer), asio::buffer(&overflow_byte, 1)};
+
+        asio::error_code error {};
+        asio::ip::udp::endpoint sender_endpoint {};
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        const auto length = socket_.receive_from(scatter_buffers, sender_endpoint, 0, error);
+        if (error == asio::error::message_size) {
+            oversized_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (error) {
+            break;
+        }
+        if (length > buffer.buffer.size()) {
+            oversized_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        buffer.address = sender_endpoint.address();
+        buffer.timestamp = std::nullopt;
+        buffer.interface_index = 0;
+        buffer.length = length;
+        ++received;
+    }
+
+    socket_.non_blocking(false);
+    return received;
+}
+
+#endif
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -22,10 +26,78 @@ struct BroadcastMessage {
     /** Address from which the broadcast message was received */
     asio::ip::address address;
 
+    /** Time at which the broadcast message was received by the kernel, if enabled via :cpp:func:`BroadcastRecv::EnableTimestamps` */
+    std::optional<std::chrono::system_clock::time_point> timestamp;
+
+    /** Index of the network interface on which the broadcast message was received, if enabled via :cpp:func:`BroadcastRecv::EnablePacketInfo`, zero otherwise */
+    unsigned int interface_index;
+
     /** Convert the content of the broadcast message to a string */
     CHIRP_API std::string content_to_string() const;
 };
 
+/** Incoming broadcast message received into caller-provided storage */
+struct BroadcastBuffer {
+    /** Caller-provided storage into which the content of the broadcast message is received */
+    std::span<std::uint8_t> buffer;
+
+    /** Length of the received broadcast message in bytes */
+    std::size_t length;
+
+    /** Address from which the broadcast message was received */
+    asio::ip::address address;
+
+    /** Time at which the broadcast message was received by the kernel, if enabled via :cpp:func:`BroadcastRecv::EnableTimestamps` */
+    std::optional<std::chrono::system_clock::time_point> timestamp;
+
+    /** Index of the network interface on which the broadcast message was received, if enabled via :cpp:func:`BroadcastRecv::EnablePacketInfo`, zero otherwise */
+    unsigned int interface_index;
+};
+
+/** Receive statistics of a :cpp:class:`BroadcastRecv` */
+struct BroadcastRecvStats {
+    /**
+     * Number of broadcast messages dropped by the kernel since the socket receive buffer was full
+     *
+     * The kernel reports its drop counter (``SO_RXQ_OVFL``) alongside received broadcast messages, thus the counter is
+     * only updated when the next broadcast message is received via the batched receive functions. Drops reported while a
+     * kernel-level filter or shard is set are counted in :cpp:member:`filter_drops` instead. Only supported on Linux,
+     * zero otherwise.
+     */
+    std::uint64_t kernel_drops;
+
+    /**
+     * Number of broadcast messages dropped by the kernel while a kernel-level filter or shard was set
+     *
+     * The kernel counts broadcast messages rejected by the filter, e.g. those of other shards, together with broadcast
+     * messages dropped since the socket receive buffer was full, such that both cannot be told apart. Updated like
+     * :cpp:member:`kernel_drops`.
+     */
+    std::uint64_t filter_drops;
+
+    /** Number of broadcast messages rejected since they did not fit into the receive buffer */
+    std::uint64_t oversized;
+
+    /**
+     * Number of system calls issued to wait for and receive broadcast messages
+     *
+     * Waits inside :cpp:func:`BroadcastRecv::Run` and of awaitable receive operations are not counted.
+     */
+    std::uint64_t syscalls;
+};
+
+/** Byte pattern at a fixed offset in a broadcast message for kernel-level filtering */
+struct BroadcastFilterPattern {
+    /** Offset of the pattern from the start of the broadcast message in bytes */
+    std::size_t offset;
+
+    /** Bytes that have to match at the given offset */
+    std::vector<std::uint8_t> bytes;
+};
+
+/** Receiver using io_uring, only available if built with io_uring support */
+class IoUringRecv;
+
 /** Broadcast receiver for incoming CHIRP broadcasts on :cpp:var:`CHIRP_PORT` */
 class BroadcastRecv {
 public:
@@ -33,8 +105,10 @@ public:
      * Construct broadcast receiver
      *
      * @param any_address Address for incoming broadcasts
+     * @param reuse_port If the socket should be bound with ``SO_REUSEPORT`` to share incoming broadcasts with other
+     *        receivers via :cpp:func:`SetShard` (only supported on platforms providing ``SO_REUSEPORT``)
      */
-    CHIRP_API BroadcastRecv(asio::ip::address any_address = asio::ip::address_v4::any());
+    CHIRP_API BroadcastRecv(asio::ip::address any_address = asio::ip::address_v4::any(), bool reuse_port = false);
 
     /**
      * Construct broadcast receiver using human readable IP address
@@ -43,6 +117,24 @@ public:
      */
     CHIRP_API BroadcastRecv(std::string_view any_ip);
 
+    CHIRP_API ~BroadcastRecv();
+
+    /**
+     * Construct broadcast receiver on an external executor
+     *
+     * Asynchronous operations of the receiver are executed by the given executor instead of by :cpp:func:`Run`, which
+     * allows to await incoming broadcasts from coroutines running on the same executor (see
+     * :cpp:func:`AwaitRecvBroadcast`). Functions with a timeout and the receive chain rely on the internal IO context
+     * and cannot be used with an external executor.
+     *
+     * @param executor Executor running the asynchronous operations of the receiver
+     * @param any_address Address for incoming broadcasts
+     * @param reuse_port If the socket should be bound with ``SO_REUSEPORT`` (see :cpp:func:`BroadcastRecv`)
+     */
+    CHIRP_API BroadcastRecv(asio::any_io_executor executor,
+                            asio::ip::address any_address = asio::ip::address_v4::any(),
+                            bool reuse_port = false);
+
     /**
      * Receive broadcast message (blocking)
      *
@@ -58,10 +150,295 @@ public:
      */
     CHIRP_API std::optional<BroadcastMessage> AsyncRecvBroadcast(std::chrono::steady_clock::duration timeout);
 
+    /**
+     * Receive multiple broadcast messages (asynchronously)
+     *
+     * Waits up to the given timeout for the first broadcast message, and then drains all further broadcast messages
+     * already queued in the socket without blocking. The content of the given messages is reused, such that no memory
+     * allocations are required if the same storage is passed repeatedly.
+     *
+     * @param messages Caller-owned storage for received broadcast messages, at most ``messages.size()`` are received
+     * @param timeout Duration for which to block function call
+     * @return Number of broadcast messages received into ``messages``, zero if no message received
+     */
+    CHIRP_API std::size_t AsyncRecvBroadcasts(std::span<BroadcastMessage> messages, std::chrono::steady_clock::duration timeout);
+
+    /**
+     * Receive multiple broadcast messages into caller-provided buffers (asynchronously)
+     *
+     * Same as :cpp:func:`AsyncRecvBroadcasts`, but the content is received directly into the storage referenced by the
+     * given buffers, such that no memory allocations are performed at all. Broadcast messages longer than the storage
+     * are rejected by their length and never copied into the storage. If the buffers differ in size, broadcast messages
+     * longer than the storage of an earlier buffer might be rejected as well, since received broadcast messages are stored
+     * consecutively.
+     *
+     * @param buffers Caller-provided buffers for received broadcast messages, at most ``buffers.size()`` are received
+     * @param timeout Duration for which to block function call
+     * @return Number of broadcast messages received into ``buffers``, zero if no message received
+     */
+    CHIRP_API std::size_t AsyncRecvBroadcasts(std::span<BroadcastBuffer> buffers, std::chrono::steady_clock::duration timeout);
+
+    /**
+     * Receive broadcast message (awaitable)
+     *
+     * Suspends the awaiting coroutine until a broadcast message is received, without blocking a thread. The receive
+     * operation is executed by the executor of the receiver, i.e. either the external executor passed on construction
+     * or :cpp:func:`Run`.
+     *
+     * @return Awaitable resolving to the received broadcast message
+     * @throws asio::system_error If the receive operation failed or was cancelled via :cpp:func:`Cancel`
+     */
+    CHIRP_API asio::awaitable<BroadcastMessage> AwaitRecvBroadcast();
+
+    /**
+     * Receive multiple broadcast messages into caller-provided buffers (awaitable)
+     *
+     * Suspends the awaiting coroutine until at least one broadcast message is received, and then drains all further
+     * broadcast messages already queued in the socket (see :cpp:func:`AsyncRecvBroadcasts`).
+     *
+     * @param buffers Caller-provided buffers for received broadcast messages, have to outlive the awaitable
+     * @return Awaitable resolving to the number of broadcast messages received into ``buffers``
+     * @throws asio::system_error If the receive operation failed or was cancelled via :cpp:func:`Cancel`
+     */
+    CHIRP_API asio::awaitable<std::size_t> AwaitRecvBroadcasts(std::span<BroadcastBuffer> buffers);
+
+    /**
+     * Cancel all pending awaitable receive operations
+     *
+     * This function is thread-safe. The cancelled awaitables throw an :cpp:class:`asio::system_error` with
+     * ``asio::error::operation_aborted``.
+     */
+    CHIRP_API void Cancel();
+
+    /**
+     * Start receiving broadcast messages continuously into caller-provided buffers (asynchronously)
+     *
+     * This sets up a persistent chain of asynchronous receive operations, which is only executed inside :cpp:func:`Run`.
+     * Whenever broadcast messages are queued in the socket, they are drained into the buffers (see
+     * :cpp:func:`AsyncRecvBroadcasts`) and the handler is called with the number of received broadcast messages. The
+     * buffers are reused for the next receive operation once the handler returns.
+     *
+     * @param buffers Caller-provided buffers for received broadcast messages, have to outlive :cpp:func:`Run`
+     * @param handler Function called from :cpp:func:`Run` with the number of broadcast messages received into ``buffers``
+     */
+    CHIRP_API void StartRecvBroadcasts(std::span<BroadcastBuffer> buffers, std::function<void(std::size_t)> handler);
+
+    /**
+     * Run the receive chain started with :cpp:func:`StartRecvBroadcasts` (blocking)
+     *
+     * Blocks without any periodic wakeups until :cpp:func:`Stop` is called. Afterwards the receive chain is cancelled.
+     */
+    CHIRP_API void Run();
+
+    /**
+     * Stop :cpp:func:`Run` immediately
+     *
+     * This function is thread-safe and can also be called before :cpp:func:`Run`, in which case :cpp:func:`Run` returns
+     * immediately.
+     */
+    CHIRP_API void Stop();
+
+    /**
+     * Attach a kernel-level filter to the socket
+     *
+     * Only broadcast messages with the given length that match all given patterns are queued in the socket, all other
+     * broadcast messages are dropped by the kernel before being copied to userspace or waking up the receiver. Attaching
+     * a new filter replaces the previous one. This uses a classic BPF program and is only supported on Linux.
+     *
+     * @param length Length of accepted broadcast messages in bytes, zero to accept broadcast messages of any length
+     * @param patterns Byte patterns that accepted broadcast messages have to match
+     * @retval true If the filter was attached
+     * @retval false If kernel-level filtering is not supported or the filter is too large
+     */
+    CHIRP_API bool AttachFilter(std::size_t length, const std::vector<BroadcastFilterPattern>& patterns);
+
+    /** Detach a previously attached kernel-level filter from the socket */
+    CHIRP_API void DetachFilter();
+
+    /**
+     * Receive only a share of incoming broadcasts, spreading them over multiple receivers (Linux only)
+     *
+     * Broadcast messages are assigned to one of ``count`` receivers bound with ``reuse_port`` by the value of the byte at
+     * the given offset modulo ``count``. This receiver only accepts broadcast messages assigned to ``index``, all other
+     * broadcast messages are dropped by the kernel (see :cpp:func:`AttachFilter`, with which it can be combined). Unicast
+     * messages, which are only delivered to a single receiver, are directed to the assigned receiver as well. This
+     * requires that the ``count`` receivers are the only receivers bound with ``reuse_port`` to :cpp:var:`CHIRP_PORT`
+     * and that receiver ``index`` was constructed as the ``index``-th of them.
+     *
+     * @param offset Offset of the byte in broadcast messages used to assign the broadcast message to a receiver
+     * @param index Index of this receiver, smaller than ``count``
+     * @param count Number of receivers sharing incoming broadcasts, one disables sharing
+     * @retval true If the share was set
+     * @retval false If sharing is not supported on this platform or the receiver was not constructed with ``reuse_port``
+     */
+    CHIRP_API bool SetShard(std::size_t offset, std::size_t index, std::size_t count);
+
+    /**
+     * Set size of the socket receive buffer
+     *
+     * The socket receive buffer holds incoming broadcast messages until they are received. If it is full, incoming
+     * broadcast messages are dropped (see :cpp:func:`GetStats`). Note that the operating system might adjust or limit the
+     * size, e.g. Linux doubles the size for bookkeeping and limits it to ``net.core.rmem_max``.
+     *
+     * @param size Requested size of the socket receive buffer in bytes
+     */
+    CHIRP_API void SetReceiveBufferSize(std::size_t size);
+
+    /**
+     * Get size of the socket receive buffer
+     *
+     * @return Actual size of the socket receive buffer in bytes
+     */
+    CHIRP_API std::size_t GetReceiveBufferSize() const;
+
+    /**
+     * Get receive statistics
+     *
+     * This function is thread-safe.
+     *
+     * @return Receive statistics of this receiver
+     */
+    CHIRP_API BroadcastRecvStats GetStats() const;
+
+    /**
+     * Enable kernel receive timestamps for incoming broadcast messages
+     *
+     * If enabled, the kernel records the time at which each broadcast message arrived (``SO_TIMESTAMPNS``), which is
+     * returned alongside broadcast messages received via the batched receive functions. Only supported on Linux.
+     *
+     * @retval true If kernel receive timestamps were enabled
+     * @retval false If kernel receive timestamps are not supported on this platform
+     */
+    CHIRP_API bool EnableTimestamps();
+
+    /**
+     * Enable reporting of the network interface on which broadcast messages are received
+     *
+     * If enabled, the kernel reports the interface index of each broadcast message (``IP_PKTINFO`` or
+     * ``IPV6_RECVPKTINFO``), which is returned alongside broadcast messages received via the batched receive functions.
+     * Only supported on Linux.
+     *
+     * @retval true If packet information was enabled
+     * @retval false If packet information is not supported on this platform
+     */
+    CHIRP_API bool EnablePacketInfo();
+
+    /**
+     * Receive broadcast messages via io_uring instead of waiting for the socket via epoll
+     *
+     * A single multishot receive operation then receives all incoming broadcast messages into a ring of buffers
+     * registered with the kernel, such that waiting for and receiving broadcast messages requires no system call per
+     * broadcast message. Only available on Linux 6.0 or newer if built with io_uring support. Has to be called before
+     * any asynchronous or awaitable receive operation is started. The receive operation is started by the first thread
+     * waiting for broadcast messages, and restarted by the next receiving thread if that thread exits.
+     *
+     * @retval true If io_uring is used for receiving broadcast messages
+     * @retval false If io_uring is not supported
+     */
+    CHIRP_API bool EnableIoUring();
+
+    /**
+     * Join multicast group to receive multicast messages in addition to broadcast messages
+     *
+     * For IPv6 link-local groups, the interface is taken from the scope ID of the address (e.g. ``ff02::7123%eth0``).
+     * On Linux, multicast messages of groups joined by other sockets on this host are not received.
+     *
+     * @param multicast_address Address of the multicast group to join
+     * @throws asio::system_error If the multicast group could not be joined
+     */
+    CHIRP_API void JoinMulticastGroup(const asio::ip::address& multicast_address);
+
+private:
+    /**
+     * Wait until a broadcast message is queued in the socket
+     *
+     * @param timeout Duration for which to block function call
+     * @return If a broadcast message can be received without blocking
+     */
+    bool WaitBroadcast(std::chrono::steady_clock::duration timeout);
+
+    /**
+     * Set socket options and bind socket
+     *
+     * @param reuse_port If the socket should be bound with ``SO_REUSEPORT``
+     */
+    void Open(bool reuse_port);
+
+    /**
+     * Receive broadcast messages already queued in the socket without blocking
+     *
+     * Received broadcast messages are stored consecutively from the front of ``buffers``, oversized broadcast messages
+     * are skipped. Since broadcast messages are moved forward past skipped ones, a broadcast message is oversized if it
+     * is longer than its buffer or any earlier buffer received into by the same system call.
+     *
+     * @param buffers Caller-provided buffers for received broadcast messages
+     * @return Number of broadcast messages received into ``buffers``
+     */
+    std::size_t DrainBroadcasts(std::span<BroadcastBuffer> buffers);
+
+    /** Wait asynchronously for the next broadcast messages of the receive chain */
+    void ContinueRecvBroadcasts();
+
+    /**
+     * Attach kernel-level filter combining message filter and shard, or detach it if neither is set
+     *
+     * @return If the filter was attached or detached successfully
+     */
+    bool UpdateFilter();
+
+    /**
+     * Count broadcast messages dropped by the kernel since the last reported drop counter
+     *
+     * @param drops Drop counter of the socket reported by the kernel
+     */
+    void RecordDrops(std::uint32_t drops);
+
 private:
     asio::io_context io_context_;
     asio::ip::udp::endpoint endpoint_;
     asio::ip::udp::socket socket_;
+
+    /** Buffers of the receive chain */
+    std::span<BroadcastBuffer> recv_buffers_;
+
+    /** Handler of the receive chain */
+    std::function<void(std::size_t)> recv_handler_;
+
+    /** Length of accepted broadcast messages, zero if no message filter set */
+    std::size_t filter_length_ {0};
+
+    /** Byte patterns accepted broadcast messages have to match */
+    std::vector<BroadcastFilterPattern> filter_patterns_;
+
+    /** Offset of the byte used to assign broadcast messages to receivers */
+    std::size_t shard_offset_ {0};
+
+    /** Index of this receiver among the receivers sharing incoming broadcasts */
+    std::size_t shard_index_ {0};
+
+    /** Number of receivers sharing incoming broadcasts */
+    std::size_t shard_count_ {1};
+
+    /** Number of broadcast messages dropped by the kernel while no filter was set */
+    std::atomic_uint64_t kernel_drops_ {0};
+
+    /** Number of broadcast messages dropped by the kernel while a filter was set */
+    std::atomic_uint64_t filter_drops_ {0};
+
+    /** Drop counter of the socket last reported by the kernel, only accessed by the receiving thread */
+    std::uint32_t reported_drops_ {0};
+
+    /** If a kernel-level filter is attached */
+    std::atomic_bool filter_attached_ {false};
+
+    /** Number of rejected oversized broadcast messages */
+    std::atomic_uint64_t oversized_ {0};
+
+    /** Number of system calls to wait for and receive broadcast messages */
+    std::atomic_uint64_t syscalls_ {0};
+
+    /** Receiver using io_uring if enabled, destroyed before the socket */
+    std::unique_ptr<IoUringRecv> io_uring_;
 };
 
 } // namespace CHIRP
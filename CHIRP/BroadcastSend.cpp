@@ -1,15 +1,49 @@
 #include "BroadcastSend.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 #include "CHIRP/protocol_info.hpp"
 
+#ifdef CHIRP_IO_URING
+#include "CHIRP/IoUring.hpp"
+#else
+// Never instantiated if built without io_uring support
+class cnstln::CHIRP::IoUringSend {};
+#endif
+
 using namespace cnstln::CHIRP;
 
+// Maximum number of messages sent per system call
+constexpr std::size_t SEND_BATCH = 64;
+
 BroadcastSend::BroadcastSend(asio::ip::address brd_address)
   : io_context_(), endpoint_(std::move(brd_address), asio::ip::port_type(CHIRP_PORT)),
     socket_(io_context_, endpoint_.protocol()) {
-    // Set reuseable address and broadcast socket options
+    // Set reuseable address socket option
     socket_.set_option(asio::socket_base::reuse_address(true));
-    socket_.set_option(asio::socket_base::broadcast(true));
+    const auto& address = endpoint_.address();
+    if (address.is_multicast()) {
+        // Keep multicasts in local network and loop them back for services on the same host
+        socket_.set_option(asio::ip::multicast::hops(1));
+        socket_.set_option(asio::ip::multicast::enable_loopback(true));
+        // Send IPv6 link-local multicasts on interface given by scope ID
+        if (address.is_v6() && address.to_v6().scope_id() != 0) {
+            socket_.set_option(asio::ip::multicast::outbound_interface(static_cast<unsigned int>(address.to_v6().scope_id())));
+        }
+    }
+    else {
+        // Set broadcast socket option
+        socket_.set_option(asio::socket_base::broadcast(true));
+    }
     // Set broadcast address for use in send() function
     socket_.connect(endpoint_);
 }
@@ -17,10 +51,143 @@ BroadcastSend::BroadcastSend(asio::ip::address brd_address)
 BroadcastSend::BroadcastSend(std::string_view brd_ip)
   : BroadcastSend(asio::ip::make_address(brd_ip)) {}
 
+BroadcastSend::~BroadcastSend() = default;
+
 void BroadcastSend::SendBroadcast(std::string_view message) {
-    socket_.send(asio::buffer(message));
+    SendBroadcast(message.data(), message.size());
 }
 
 void BroadcastSend::SendBroadcast(const void* data, std::size_t size) {
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        const asio::const_buffer message {data, size};
+        asio::error_code error {};
+        io_uring_->Send({&message, 1}, {&error, 1});
+        if (error) {
+            throw asio::system_error(error, "io_uring send");
+        }
+        return;
+    }
+#endif
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
     socket_.send(asio::const_buffer(data, size));
 }
+
+void BroadcastSend::SendBroadcasts(std::span<const asio::const_buffer> messages) {
+    std::array<asio::error_code, SEND_BATCH> errors {};
+    asio::error_code first_error {};
+    for (std::size_t offset = 0; offset < messages.size(); offset += SEND_BATCH) {
+        const auto batch = std::min(messages.size() - offset, SEND_BATCH);
+        const auto batch_errors = std::span(errors).first(batch);
+        if (TrySendBroadcasts(messages.subspan(offset, batch), batch_errors) < batch && !first_error) {
+            first_error = *std::ranges::find_if(batch_errors, [](const auto& error) { return static_cast<bool>(error); });
+        }
+    }
+    // Report first error only after all other messages were sent
+    if (first_error) {
+        throw asio::system_error(first_error, "send");
+    }
+}
+
+#ifdef __linux__
+
+std::size_t BroadcastSend::TrySendBroadcasts(std::span<const asio::const_buffer> messages, std::span<asio::error_code> errors) {
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        return io_uring_->Send(messages, errors);
+    }
+#endif
+    std::array<mmsghdr, SEND_BATCH> msg_headers {};
+    std::array<iovec, SEND_BATCH> iovecs {};
+
+    std::size_t attempted = 0;
+    std::size_t sent = 0;
+    while (attempted < messages.size()) {
+        const auto batch = std::min(messages.size() - attempted, SEND_BATCH);
+
+        // Socket is connected, so only the message data is required
+        for (std::size_t n = 0; n < batch; ++n) {
+            const auto& message = messages[attempted + n];
+            iovecs[n] = {const_cast<void*>(message.data()), message.size()};
+            msg_headers[n] = {};
+            msg_headers[n].msg_hdr.msg_iov = &iovecs[n];
+            msg_headers[n].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Send all messages in a single system call, which stops before the first message that could not be sent
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        const auto ret = ::sendmmsg(socket_.native_handle(), msg_headers.data(), static_cast<unsigned int>(batch), 0);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // First message failed, skip it such that the remaining messages are still sent
+            errors[attempted] = asio::error_code(errno, asio::error::get_system_category());
+            ++attempted;
+            continue;
+        }
+        std::fill_n(errors.begin() + static_cast<std::ptrdiff_t>(attempted), ret, asio::error_code());
+        attempted += static_cast<std::size_t>(ret);
+        sent += static_cast<std::size_t>(ret);
+    }
+    return sent;
+}
+
+#else
+
+std::size_t BroadcastSend::TrySendBroadcasts(std::span<const asio::const_buffer> messages, std::span<asio::error_code> errors) {
+    std::size_t sent = 0;
+    for (std::size_t n = 0; n < messages.size(); ++n) {
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        socket_.send(messages[n], 0, errors[n]);
+        sent += errors[n] ? 0 : 1;
+    }
+    return sent;
+}
+
+#endif
+
+void BroadcastSend::SetSendBufferSize(std::size_t size) {
+    socket_.set_option(asio::socket_base::send_buffer_size(static_cast<int>(size)));
+}
+
+std::size_t BroadcastSend::GetSendBufferSize() const {
+    asio::socket_base::send_buffer_size option {};
+    socket_.get_option(option);
+    return static_cast<std::size_t>(option.value());
+}
+
+void BroadcastSend::SetMulticastHops(int hops) {
+    socket_.set_option(asio::ip::multicast::hops(hops));
+}
+
+void BroadcastSend::SetMulticastLoopback(bool loopback) {
+    socket_.set_option(asio::ip::multicast::enable_loopback(loopback));
+}
+
+bool BroadcastSend::EnableIoUring() {
+#ifdef CHIRP_IO_URING
+    if (!io_uring_) {
+        try {
+            io_uring_ = std::make_unique<IoUringSend>(socket_);
+        }
+        catch (const std::system_error&) {
+            // Kernel does not support io_uring
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::uint64_t BroadcastSend::GetSyscalls() const {
+    auto syscalls = syscalls_.load(std::memory_order_relaxed);
+#ifdef CHIRP_IO_URING
+    if (io_uring_) {
+        syscalls += io_uring_->GetSyscalls();
+    }
+#endif
+    return syscalls;
+}
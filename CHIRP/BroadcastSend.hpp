@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string_view>
 
 #include "asio.hpp"
@@ -9,23 +13,33 @@
 namespace cnstln {
 namespace CHIRP {
 
-/** Broadcast sender for outgoing CHIRP broadcasts on :cpp:var:`CHIRP_PORT` */
+/** Sender using io_uring, only available if built with io_uring support */
+class IoUringSend;
+
+/**
+ * Broadcast sender for outgoing CHIRP broadcasts on :cpp:var:`CHIRP_PORT`
+ *
+ * If constructed with a multicast address, messages are sent to the multicast group instead. For IPv6 link-local groups,
+ * the outgoing interface is taken from the scope ID of the address (e.g. ``ff02::7123%eth0``).
+ */
 class BroadcastSend {
 public:
     /**
      * Construct broadcast sender
      *
-     * @param brd_address Broadcast address for outgoing broadcasts
+     * @param brd_address Broadcast or multicast address for outgoing broadcasts
      */
     CHIRP_API BroadcastSend(asio::ip::address brd_address = asio::ip::address_v4::any());
 
     /**
      * Construct broadcast sender using human readable IP address
      *
-     * @param brd_ip String containing the broadcast IP for outgoing broadcasts
+     * @param brd_ip String containing the broadcast or multicast IP for outgoing broadcasts
      */
     CHIRP_API BroadcastSend(std::string_view brd_ip);
 
+    CHIRP_API ~BroadcastSend();
+
     /**
      * Send broadcast message from string
      *
@@ -41,10 +55,92 @@ public:
      */
     CHIRP_API void SendBroadcast(const void* data, std::size_t size);
 
+    /**
+     * Send multiple broadcast messages
+     *
+     * On Linux, the messages are sent with a single system call per 64 messages (``sendmmsg`` or io_uring if enabled),
+     * otherwise one by one.
+     *
+     * @param messages Buffers with the data of each message
+     * @throws asio::system_error If a message could not be sent, after all other messages were sent
+     */
+    CHIRP_API void SendBroadcasts(std::span<const asio::const_buffer> messages);
+
+    /**
+     * Send multiple broadcast messages without throwing
+     *
+     * Like :cpp:func:`SendBroadcasts`, but messages that could not be sent are reported per message instead of throwing,
+     * such that callers know exactly which messages were sent.
+     *
+     * @param messages Buffers with the data of each message
+     * @param errors Set to the error of each message, has to be at least as large as ``messages``
+     * @return Number of messages sent without error
+     */
+    CHIRP_API std::size_t TrySendBroadcasts(std::span<const asio::const_buffer> messages, std::span<asio::error_code> errors);
+
+    /**
+     * Set size of the socket send buffer
+     *
+     * Note that the operating system might adjust or limit the size, e.g. Linux doubles the size for bookkeeping and
+     * limits it to ``net.core.wmem_max``.
+     *
+     * @param size Requested size of the socket send buffer in bytes
+     */
+    CHIRP_API void SetSendBufferSize(std::size_t size);
+
+    /**
+     * Get size of the socket send buffer
+     *
+     * @return Actual size of the socket send buffer in bytes
+     */
+    CHIRP_API std::size_t GetSendBufferSize() const;
+
+    /**
+     * Set number of hops (TTL) of outgoing multicast messages
+     *
+     * By default, multicast messages do not leave the local network (one hop).
+     *
+     * @param hops Number of hops after which multicast messages are discarded
+     */
+    CHIRP_API void SetMulticastHops(int hops);
+
+    /**
+     * Set if outgoing multicast messages are looped back to sockets on this host
+     *
+     * Enabled by default, which is required to discover services running on the same host.
+     *
+     * @param loopback If multicast messages are looped back
+     */
+    CHIRP_API void SetMulticastLoopback(bool loopback);
+
+    /**
+     * Send broadcast messages via io_uring instead of ``send`` and ``sendmmsg``
+     *
+     * All messages passed to :cpp:func:`SendBroadcasts` are then submitted with a single system call per 64 messages,
+     * which also waits for them to be sent. Only available on Linux 5.6 or newer if built with io_uring support.
+     *
+     * @retval true If io_uring is used for sending broadcast messages
+     * @retval false If io_uring is not supported
+     */
+    CHIRP_API bool EnableIoUring();
+
+    /**
+     * Get number of system calls issued to send broadcast messages
+     *
+     * @return Number of system calls since construction
+     */
+    CHIRP_API std::uint64_t GetSyscalls() const;
+
 private:
     asio::io_context io_context_;
     asio::ip::udp::endpoint endpoint_;
     asio::ip::udp::socket socket_;
+
+    /** Number of system calls to send broadcast messages, excluding those of :cpp:member:`io_uring_` */
+    std::atomic_uint64_t syscalls_ {0};
+
+    /** Sender using io_uring if enabled, destroyed before the socket */
+    std::unique_ptr<IoUringSend> io_uring_;
 };
 
 } // namespace CHIRP
@@ -0,0 +1,396 @@
+#include "IoUring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace cnstln::CHIRP;
+
+// Number of buffers in the buffer ring, has to be a power of two
+constexpr std::uint16_t BUFFER_COUNT = 256;
+
+// Buffer group ID of the buffer ring
+constexpr std::uint16_t BUFFER_GROUP = 0;
+
+// Number of send operations submitted per system call
+constexpr unsigned int SEND_BATCH = 64;
+
+// User data identifying the completions of the receive operations, send operations use the index of their message
+constexpr std::uint64_t RECV_USER_DATA = 1;
+constexpr std::uint64_t CANCEL_USER_DATA = 2;
+
+namespace {
+    std::system_error SystemError(int error, const char* what) {
+        return {error, std::system_category(), what};
+    }
+
+    std::size_t AlignUp(std::size_t size, std::size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+}
+
+IoUring::Mapping::Mapping() : data(MAP_FAILED), size(0) {}
+
+IoUring::Mapping::~Mapping() {
+    if (data != MAP_FAILED) {
+        ::munmap(data, size);
+    }
+}
+
+IoUring::IoUring(const asio::any_io_executor& executor, unsigned int entries, unsigned int cq_entries)
+  : descriptor_(executor) {
+    io_uring_params params {};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = cq_entries;
+    auto ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd < 0 && errno == EINVAL) {
+        // Cooperative task running not supported before Linux 5.19
+        params.flags &= ~IORING_SETUP_COOP_TASKRUN;
+        ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    }
+    if (ring_fd < 0) {
+        throw SystemError(errno, "io_uring_setup");
+    }
+    descriptor_.assign(ring_fd);
+
+    // Map submission and completion queues
+    sq_ring_.size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    cq_ring_.size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        sq_ring_.size = std::max(sq_ring_.size, cq_ring_.size);
+    }
+    sq_ring_.data = ::mmap(nullptr, sq_ring_.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring_.data == MAP_FAILED) {
+        throw SystemError(errno, "mmap");
+    }
+    auto* cq_ring_data = sq_ring_.data;
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+        cq_ring_.data = ::mmap(nullptr, cq_ring_.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring_.data == MAP_FAILED) {
+            throw SystemError(errno, "mmap");
+        }
+        cq_ring_data = cq_ring_.data;
+    }
+    sqes_.size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_.data = ::mmap(nullptr, sqes_.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes_.data == MAP_FAILED) {
+        throw SystemError(errno, "mmap");
+    }
+
+    auto* sq_ring = static_cast<std::byte*>(sq_ring_.data);
+    sq_tail_ = reinterpret_cast<std::uint32_t*>(sq_ring + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<std::uint32_t*>(sq_ring + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<std::uint32_t*>(sq_ring + params.sq_off.array);
+    auto* cq_ring = static_cast<std::byte*>(cq_ring_data);
+    cq_head_ = reinterpret_cast<std::uint32_t*>(cq_ring + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<std::uint32_t*>(cq_ring + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<std::uint32_t*>(cq_ring + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+}
+
+bool IoUring::Ready() const {
+    return *cq_head_ != std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+}
+
+const io_uring_cqe* IoUring::PeekCqe() const {
+    return Ready() ? &cqes_[*cq_head_ & cq_mask_] : nullptr;
+}
+
+bool IoUring::NextCqe(io_uring_cqe& cqe) {
+    const auto head = *cq_head_;
+    if (head == std::atomic_ref(*cq_tail_).load(std::memory_order_acquire)) {
+        return false;
+    }
+    cqe = cqes_[head & cq_mask_];
+    std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+    return true;
+}
+
+int IoUring::Enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags, const void* arg, std::size_t arg_size) {
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    int ret = 0;
+    do {
+        ret = static_cast<int>(::syscall(__NR_io_uring_enter, descriptor_.native_handle(), to_submit, min_complete, flags, arg, arg_size));
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+io_uring_sqe& IoUring::NextSqe() {
+    // Callers never prepare more entries than the submission queue holds before submitting them
+    const auto index = (*sq_tail_ + prepared_++) & sq_mask_;
+    auto& sqe = static_cast<io_uring_sqe*>(sqes_.data)[index];
+    sqe = {};
+    sq_array_[index] = index;
+    return sqe;
+}
+
+int IoUring::Submit(unsigned int min_complete, unsigned int flags) {
+    // Publish entries prepared via NextSqe
+    const auto prepared = std::exchange(prepared_, 0);
+    std::atomic_ref(*sq_tail_).fetch_add(prepared, std::memory_order_release);
+    const auto ret = Enter(prepared, min_complete, flags, nullptr, 0);
+    const auto submitted = static_cast<std::uint32_t>(std::max(ret, 0));
+    if (submitted < prepared) {
+        // Discard entries the kernel did not consume such that they are not submitted later
+        std::atomic_ref(*sq_tail_).fetch_sub(prepared - submitted, std::memory_order_release);
+    }
+    return ret;
+}
+
+// Completion queue is sized such that it cannot overflow while all buffers are in use
+IoUringRecv::IoUringRecv(asio::ip::udp::socket& socket, std::size_t payload_size, std::size_t control_size)
+  : IoUring(socket.get_executor(), 4, 2 * BUFFER_COUNT), socket_fd_(socket.native_handle()) {
+    // Register ring of buffers provided to the kernel
+    buf_ring_.size = BUFFER_COUNT * sizeof(io_uring_buf);
+    buf_ring_.data = ::mmap(nullptr, buf_ring_.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring_.data == MAP_FAILED) {
+        throw SystemError(errno, "mmap");
+    }
+    io_uring_buf_reg buf_reg {};
+    buf_reg.ring_addr = reinterpret_cast<std::uintptr_t>(buf_ring_.data);
+    buf_reg.ring_entries = BUFFER_COUNT;
+    buf_reg.bgid = BUFFER_GROUP;
+    if (::syscall(__NR_io_uring_register, descriptor_.native_handle(), IORING_REGISTER_PBUF_RING, &buf_reg, 1) != 0) {
+        throw SystemError(errno, "io_uring_register");
+    }
+    // Tail of the buffer ring overlaps with the reserved field of the first buffer
+    buf_tail_ = reinterpret_cast<std::uint16_t*>(static_cast<std::byte*>(buf_ring_.data) + offsetof(io_uring_buf, resv));
+
+    // Each buffer contains the receive header, the sender address, the control messages and the payload
+    msg_template_.msg_namelen = sizeof(sockaddr_storage);
+    msg_template_.msg_controllen = AlignUp(control_size, alignof(cmsghdr));
+    buffer_size_ = AlignUp(sizeof(io_uring_recvmsg_out) + msg_template_.msg_namelen + msg_template_.msg_controllen + payload_size,
+                           alignof(std::max_align_t));
+    buffers_.resize(BUFFER_COUNT * buffer_size_);
+    for (std::uint16_t buffer_id = 0; buffer_id < BUFFER_COUNT; ++buffer_id) {
+        Recycle({buffer_id, {}, {}});
+    }
+
+    // Check that multishot receive operations are supported (Linux 6.0 or newer) on a socket which never receives messages,
+    // the receive operation on the socket is only started by the receiving thread
+    asio::ip::udp::socket probe {socket.get_executor(), asio::ip::udp::v4()};
+    if (SubmitRecv(probe.native_handle()) != 1) {
+        throw SystemError(errno, "io_uring_enter");
+    }
+    const auto* cqe = PeekCqe();
+    if (cqe != nullptr && cqe->res == -EINVAL) {
+        throw SystemError(EINVAL, "multishot recvmsg");
+    }
+    Disarm();
+}
+
+IoUringRecv::~IoUringRecv() {
+    if (armed_) {
+        Disarm();
+    }
+}
+
+void IoUringRecv::Disarm() {
+    armed_ = false;
+
+    // Cancel receive operation
+    auto& sqe = NextSqe();
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = RECV_USER_DATA;
+    sqe.user_data = CANCEL_USER_DATA;
+    if (Submit(0, 0) != 1) {
+        return;
+    }
+
+    // Reap completions until both the cancellation and the final completion of the receive operation arrived, only then
+    // the kernel no longer writes into the buffers
+    bool cancelled = false;
+    bool terminated = false;
+    io_uring_cqe cqe {};
+    while (!cancelled || !terminated) {
+        while (NextCqe(cqe)) {
+            if (cqe.user_data == CANCEL_USER_DATA) {
+                cancelled = true;
+            }
+            else if (cqe.user_data == RECV_USER_DATA && (cqe.flags & IORING_CQE_F_MORE) == 0) {
+                terminated = true;
+            }
+        }
+        if ((!cancelled || !terminated) && Enter(0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            break;
+        }
+    }
+}
+
+void IoUringRecv::Arm() {
+    if (armed_) {
+        return;
+    }
+    const auto submitted = SubmitRecv(socket_fd_);
+    if (submitted != 1) {
+        throw SystemError(submitted < 0 ? errno : EAGAIN, "io_uring_enter");
+    }
+    armed_ = true;
+}
+
+bool IoUringRecv::Wait(std::chrono::steady_clock::duration timeout) {
+    if (Ready()) {
+        return true;
+    }
+    Arm();
+
+    // Wait for first completion with timeout
+    timeout = std::max(timeout, std::chrono::steady_clock::duration::zero());
+    const auto timeout_s = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    __kernel_timespec timeout_ts {};
+    timeout_ts.tv_sec = timeout_s.count();
+    timeout_ts.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - timeout_s).count();
+    io_uring_getevents_arg getevents_arg {};
+    getevents_arg.ts = reinterpret_cast<std::uintptr_t>(&timeout_ts);
+    if (Enter(0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &getevents_arg, sizeof(getevents_arg)) < 0 && errno != ETIME) {
+        throw SystemError(errno, "io_uring_enter");
+    }
+
+    return Ready();
+}
+
+void IoUringRecv::Wait() {
+    while (!Ready()) {
+        Arm();
+        if (Enter(0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            throw SystemError(errno, "io_uring_enter");
+        }
+    }
+}
+
+void IoUringRecv::Cancel() {
+    descriptor_.cancel();
+}
+
+bool IoUringRecv::Next(Message& message) {
+    bool rearmed = false;
+    io_uring_cqe cqe {};
+    while (true) {
+        if (!NextCqe(cqe)) {
+            // Restart receive operation once, which completes immediately if messages are queued in the socket
+            if (armed_ || rearmed) {
+                return false;
+            }
+            Arm();
+            rearmed = true;
+            continue;
+        }
+
+        if (cqe.user_data != RECV_USER_DATA) {
+            continue;
+        }
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+            // Receive operation terminated, e.g. no buffer available, messages stay queued in the socket
+            armed_ = false;
+        }
+        if (cqe.res < 0 || (cqe.flags & IORING_CQE_F_BUFFER) == 0) {
+            continue;
+        }
+
+        // Locate receive header, sender address, control messages and payload in the buffer
+        const auto buffer_id = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        auto* buffer = buffers_.data() + buffer_id * buffer_size_;
+        io_uring_recvmsg_out recvmsg_out {};
+        std::memcpy(&recvmsg_out, buffer, sizeof(recvmsg_out));
+        auto* name = buffer + sizeof(io_uring_recvmsg_out);
+        auto* control = name + msg_template_.msg_namelen;
+        auto* payload = control + msg_template_.msg_controllen;
+
+        message.buffer_id = buffer_id;
+        message.header = {};
+        message.header.msg_name = name;
+        message.header.msg_namelen = std::min(recvmsg_out.namelen, msg_template_.msg_namelen);
+        message.header.msg_control = control;
+        message.header.msg_controllen = recvmsg_out.controllen;
+        message.header.msg_flags = static_cast<int>(recvmsg_out.flags);
+        const auto payload_offset = static_cast<std::size_t>(payload - buffer);
+        message.payload = {payload, static_cast<std::size_t>(cqe.res) - payload_offset};
+        return true;
+    }
+}
+
+void IoUringRecv::Recycle(const Message& message) {
+    // Add buffer at the tail of the buffer ring, only the fields not overlapping with the tail are written
+    const auto tail = *buf_tail_;
+    auto& buf = static_cast<io_uring_buf*>(buf_ring_.data)[tail & (BUFFER_COUNT - 1)];
+    buf.addr = reinterpret_cast<std::uintptr_t>(buffers_.data() + message.buffer_id * buffer_size_);
+    buf.len = static_cast<std::uint32_t>(buffer_size_);
+    buf.bid = message.buffer_id;
+    std::atomic_ref(*buf_tail_).store(static_cast<std::uint16_t>(tail + 1), std::memory_order_release);
+}
+
+int IoUringRecv::SubmitRecv(int fd) {
+    auto& sqe = NextSqe();
+    sqe.opcode = IORING_OP_RECVMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&msg_template_);
+    sqe.len = 1;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    sqe.user_data = RECV_USER_DATA;
+    return Submit(0, 0);
+}
+
+IoUringSend::IoUringSend(asio::ip::udp::socket& socket)
+  : IoUring(socket.get_executor(), SEND_BATCH, 2 * SEND_BATCH), socket_fd_(socket.native_handle()) {}
+
+std::size_t IoUringSend::Send(std::span<const asio::const_buffer> messages, std::span<asio::error_code> errors) {
+    io_uring_cqe cqe {};
+    int wait_error = 0;
+    std::size_t submitted_total = 0;
+    std::size_t sent = 0;
+    while (submitted_total < messages.size()) {
+        const auto batch = std::min(messages.size() - submitted_total, std::size_t(SEND_BATCH));
+
+        // Socket is connected, so only the message data is required
+        for (std::size_t n = submitted_total; n < submitted_total + batch; ++n) {
+            auto& sqe = NextSqe();
+            sqe.opcode = IORING_OP_SEND;
+            sqe.fd = socket_fd_;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(messages[n].data());
+            sqe.len = static_cast<std::uint32_t>(messages[n].size());
+            sqe.user_data = n;
+        }
+
+        // Submit without waiting since the kernel might submit fewer messages than prepared
+        const auto submitted = Submit(0, 0);
+        if (submitted <= 0) {
+            // Nothing of this batch is in flight and all previous batches are reaped
+            throw asio::system_error(asio::error_code(submitted < 0 ? errno : EAGAIN, asio::error::get_system_category()), "io_uring_enter");
+        }
+
+        // Reap completions of all submitted messages since the buffers are only valid until returning, even if waiting
+        // fails, in which case completions are polled instead
+        for (int completed = 0; completed < submitted;) {
+            if (!NextCqe(cqe)) {
+                if (Enter(0, static_cast<unsigned int>(submitted - completed), IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+                    wait_error = errno;
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            ++completed;
+            if (cqe.res < 0) {
+                errors[cqe.user_data] = asio::error_code(-cqe.res, asio::error::get_system_category());
+            }
+            else {
+                errors[cqe.user_data] = {};
+                ++sent;
+            }
+        }
+        submitted_total += static_cast<std::size_t>(submitted);
+        if (wait_error != 0) {
+            throw asio::system_error(asio::error_code(wait_error, asio::error::get_system_category()), "io_uring_enter");
+        }
+    }
+    return sent;
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+#include "asio.hpp"
+
+namespace cnstln {
+namespace CHIRP {
+
+/**
+ * Submission and completion queues of an io_uring instance
+ *
+ * The queues are mapped into memory shared with the kernel, such that operations are submitted and completions are
+ * taken without a system call per operation. The ring is closed on destruction, thus derived classes have to wait for
+ * all operations using their memory to complete before releasing it.
+ */
+class IoUring {
+public:
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * Get number of system calls issued for the ring
+     *
+     * @return Number of system calls for submitting operations and waiting for completions
+     */
+    std::uint64_t GetSyscalls() const { return syscalls_.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * Set up io_uring and map its queues
+     *
+     * @param executor Executor for asynchronous waits on the ring
+     * @param entries Number of entries of the submission queue
+     * @param cq_entries Number of entries of the completion queue, at least twice the number of submission queue entries
+     * @throws std::system_error If io_uring is not supported
+     */
+    IoUring(const asio::any_io_executor& executor, unsigned int entries, unsigned int cq_entries);
+
+    ~IoUring() = default;
+
+    /** Memory mapping unmapped on destruction */
+    struct Mapping {
+        void* data;
+        std::size_t size;
+
+        Mapping();
+        ~Mapping();
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+    };
+
+    /** Check if completions are queued */
+    bool Ready() const;
+
+    /** Get the next completion without taking it, nullptr if no completion is queued */
+    const io_uring_cqe* PeekCqe() const;
+
+    /**
+     * Take the next completion without blocking
+     *
+     * @param cqe Completion queue entry to store the completion in
+     * @return If a completion was taken
+     */
+    bool NextCqe(io_uring_cqe& cqe);
+
+    /** Submit queued entries and wait for completions via io_uring_enter */
+    int Enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags, const void* arg, std::size_t arg_size);
+
+    /** Get next free submission queue entry, submitted with the next call to :cpp:func:`Submit` */
+    io_uring_sqe& NextSqe();
+
+    /**
+     * Submit all entries prepared via :cpp:func:`NextSqe`
+     *
+     * If no entry could be submitted, the prepared entries are discarded.
+     *
+     * @return Number of submitted entries, or negative if no entry could be submitted
+     */
+    int Submit(unsigned int min_complete, unsigned int flags);
+
+protected:
+    asio::posix::stream_descriptor descriptor_;
+
+private:
+    Mapping sq_ring_;
+    Mapping cq_ring_;
+    Mapping sqes_;
+
+    std::uint32_t* sq_tail_ {nullptr};
+    std::uint32_t sq_mask_ {0};
+    std::uint32_t* sq_array_ {nullptr};
+    std::uint32_t* cq_head_ {nullptr};
+    std::uint32_t* cq_tail_ {nullptr};
+    std::uint32_t cq_mask_ {0};
+    io_uring_cqe* cqes_ {nullptr};
+
+    /** Number of entries prepared via :cpp:func:`NextSqe` but not yet submitted */
+    std::uint32_t prepared_ {0};
+
+    std::atomic_uint64_t syscalls_ {0};
+};
+
+/**
+ * Receiver for a UDP socket using io_uring
+ *
+ * Messages are received by a single multishot receive operation into a ring of buffers registered with the kernel, such
+ * that no system call is required per received message. Completed receive operations are signalled via the file
+ * descriptor of the ring, which can be waited for asynchronously. Only available on Linux 6.0 or newer.
+ *
+ * The kernel cancels operations when the thread which submitted them exits, thus the receive operation is only started
+ * by the thread waiting for messages. If that thread exits, the receive operation is restarted by the next thread taking
+ * messages via :cpp:func:`Next`.
+ */
+class IoUringRecv : public IoUring {
+public:
+    /** Message received into a buffer of the ring, valid until the buffer is recycled via :cpp:func:`Recycle` */
+    struct Message {
+        /** ID of the buffer containing the message */
+        std::uint16_t buffer_id;
+
+        /** Message header with name and control messages, pointing into the buffer */
+        msghdr header;
+
+        /** Received payload, truncated if the message did not fit in the buffer */
+        std::span<std::uint8_t> payload;
+    };
+
+    /**
+     * Set up io_uring for receiving messages from the socket
+     *
+     * @param socket Socket to receive messages from, has to outlive the receiver
+     * @param payload_size Maximum size of the payload of received messages
+     * @param control_size Size reserved for control messages of received messages
+     * @throws std::system_error If io_uring or multishot receive operations are not supported
+     */
+    IoUringRecv(asio::ip::udp::socket& socket, std::size_t payload_size, std::size_t control_size);
+
+    ~IoUringRecv();
+
+    /**
+     * Start the multishot receive operation from the calling thread if it is not active
+     *
+     * @throws std::system_error If the receive operation could not be submitted
+     */
+    void Arm();
+
+    /**
+     * Wait until a message is received (blocking)
+     *
+     * @param timeout Duration for which to block function call
+     * @return If a message can be taken via :cpp:func:`Next` without blocking
+     * @throws std::system_error If the receive operation could not be submitted or waiting failed
+     */
+    bool Wait(std::chrono::steady_clock::duration timeout);
+
+    /**
+     * Wait until a message is received without timeout (blocking)
+     *
+     * @throws std::system_error If the receive operation could not be submitted or waiting failed
+     */
+    void Wait();
+
+    /**
+     * Wait asynchronously until a message is received
+     *
+     * The receive operation is started from the calling thread, which should thus be the thread running the executor.
+     *
+     * @param token Completion token called or resumed with an :cpp:class:`asio::error_code`
+     * @throws std::system_error If the receive operation could not be submitted
+     */
+    template <typename CompletionToken> auto AsyncWait(CompletionToken&& token) {
+        Arm();
+        return descriptor_.async_wait(asio::posix::descriptor_base::wait_read, std::forward<CompletionToken>(token));
+    }
+
+    /** Cancel pending asynchronous waits, has to be called from the executor of the socket */
+    void Cancel();
+
+    /**
+     * Take the next received message without blocking
+     *
+     * The receive operation is restarted if it was terminated, e.g. because all buffers were in use.
+     *
+     * @param message Message to store the received message in
+     * @return If a message was taken
+     * @throws std::system_error If the receive operation could not be restarted
+     */
+    bool Next(Message& message);
+
+    /**
+     * Return the buffer of a message to the kernel for further receive operations
+     *
+     * @param message Message taken via :cpp:func:`Next`
+     */
+    void Recycle(const Message& message);
+
+private:
+    /**
+     * Submit multishot receive operation
+     *
+     * @param fd Socket to receive messages from
+     * @return Number of submitted entries, or negative if the entry could not be submitted
+     */
+    int SubmitRecv(int fd);
+
+    /** Cancel the receive operation and wait until the kernel no longer writes into the buffers */
+    void Disarm();
+
+private:
+    int socket_fd_;
+
+    Mapping buf_ring_;
+
+    /** Tail of the buffer ring as published to the kernel */
+    std::uint16_t* buf_tail_ {nullptr};
+
+    /** Storage for all buffers of the buffer ring */
+    std::vector<std::uint8_t> buffers_;
+    std::size_t buffer_size_;
+
+    /** Message header template defining the layout of the buffers */
+    msghdr msg_template_ {};
+
+    /** If the multishot receive operation is active */
+    bool armed_ {false};
+};
+
+/**
+ * Sender for a connected UDP socket using io_uring
+ *
+ * All messages of a batch are submitted as send operations with a single system call, afterwards the completions of
+ * all submitted messages are awaited before the next batch is submitted. Only available on Linux 5.6 or newer.
+ */
+class IoUringSend : public IoUring {
+public:
+    /**
+     * Set up io_uring for sending messages via the socket
+     *
+     * @param socket Connected socket to send messages with, has to outlive the sender
+     * @throws std::system_error If io_uring is not supported
+     */
+    explicit IoUringSend(asio::ip::udp::socket& socket);
+
+    /**
+     * Send messages and wait until all of them are sent (blocking)
+     *
+     * @param messages Buffers with the data of each message
+     * @param errors Set to the error of each message, same size as ``messages``
+     * @return Number of messages sent without error
+     * @throws asio::system_error If submitting or waiting failed, after all submitted messages completed
+     */
+    std::size_t Send(std::span<const asio::const_buffer> messages, std::span<asio::error_code> errors);
+
+private:
+    int socket_fd_;
+};
+
+} // namespace CHIRP
+} // namespace cnstln
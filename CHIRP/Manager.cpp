@@ -1,19 +1,354 @@
 #include "Manager.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cstdint>
 #include <chrono>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <random>
 #include <utility>
 
 #include <iostream>
 
-#include "CHIRP/exceptions.hpp"
-
 using namespace cnstln::CHIRP;
 using namespace std::literals::chrono_literals;
 
+// Maximum number of broadcast messages handled per wakeup of the run loop
+constexpr std::size_t RECV_BATCH_SIZE = 64;
+
+// Maximum number of CHIRP broadcasts sent in one batch
+constexpr std::size_t SEND_BATCH_SIZE = 64;
+
+// Capacity of the send queue, has to be a power of two
+constexpr std::size_t SEND_QUEUE_CAPACITY = 1024;
+
+// Index of the reply state for reply rounds offering all registered services in CHIRP v2 messages, not a valid service
+// identifier
+constexpr std::size_t PACKED_REPLY = 0;
+
+// Maximum number of queued discovery callbacks per callback thread, has to be a power of two
+constexpr std::size_t CALLBACK_QUEUE_CAPACITY = 1024;
+
+// Resolution of the expiry of discovered services
+constexpr auto EXPIRY_TICK = 1ms;
+
+// Number of callback threads unless set via Manager::SetCallbackThreads
+constexpr std::size_t DEFAULT_CALLBACK_THREADS = 4;
+
+namespace {
+    // Bounded multi-producer single-consumer queue, each cell carries a sequence number telling producers and the
+    // consumer whether the cell is free or filled for the current lap around the ring
+    template <typename T, std::size_t Capacity>
+    class BoundedQueue {
+        static_assert(std::has_single_bit(Capacity), "capacity has to be a power of two");
+
+    public:
+        BoundedQueue() {
+            for (std::size_t n = 0; n < cells_.size(); ++n) {
+                cells_[n].sequence.store(n, std::memory_order_relaxed);
+            }
+        }
+
+        // Fill a free cell via fill(T&), returns false if the queue is full
+        template <typename Fill> bool TryPush(Fill&& fill) {
+            auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                auto& cell = cells_[pos % cells_.size()];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == pos) {
+                    // Cell free, claim it
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        fill(cell.value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (sequence < pos) {
+                    // Cell not yet consumed in previous lap
+                    return false;
+                }
+                else {
+                    // Cell claimed by other producer
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Pass oldest filled cell to consume(T&), only called by the consumer
+        template <typename Consume> bool TryPop(Consume&& consume) {
+            auto& cell = cells_[dequeue_pos_ % cells_.size()];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+                return false;
+            }
+            consume(cell.value);
+            cell.sequence.store(dequeue_pos_ + cells_.size(), std::memory_order_release);
+            ++dequeue_pos_;
+            return true;
+        }
+
+        // Number of values pushed since construction
+        std::size_t Pushed() const { return enqueue_pos_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Cell {
+            std::atomic_size_t sequence;
+            T value;
+        };
+
+        std::array<Cell, Capacity> cells_;
+        std::atomic_size_t enqueue_pos_ {0};
+        std::size_t dequeue_pos_ {0};
+    };
+} // namespace
+
+struct cnstln::CHIRP::SendQueue {
+    // Either a CHIRP v1 or CHIRP v2 message
+    struct QueuedMessage {
+        std::array<std::uint8_t, CHIRP_V2_MAX_MESSAGE_LENGTH> data;
+        std::size_t length;
+    };
+
+    BoundedQueue<QueuedMessage, SEND_QUEUE_CAPACITY> messages;
+
+    // Incremented after each push to wake up the consumer
+    std::atomic_uint64_t signal {0};
+
+    // Messages kept while the queue was full, sent once the queue is drained
+    std::vector<QueuedMessage> overflow;
+    std::mutex overflow_mutex;
+
+    // If overflow is not empty, further messages are not pushed to the queue such that they stay in order
+    std::atomic_bool overflowing {false};
+
+    std::atomic_uint64_t overflowed {0};
+    std::atomic_uint64_t sent {0};
+    std::atomic_uint64_t failed {0};
+    std::atomic_uint64_t dropped {0};
+
+    // Push message, returns false if the queue is full
+    bool TryPush(std::span<const std::uint8_t> message) {
+        return messages.TryPush([&](QueuedMessage& queued_message) {
+            std::ranges::copy(message, queued_message.data.begin());
+            queued_message.length = message.size();
+        });
+    }
+
+    // Push message and wake up the consumer. If the queue is full, the message is either kept in the overflow or counted
+    // as dropped. Only DEPARTs are kept, since peers would keep departed services until they expire, while lost OFFERs
+    // are recovered by REQUESTs.
+    bool Push(std::span<const std::uint8_t> message, bool keep_if_full) {
+        if (!overflowing.load(std::memory_order_acquire) && TryPush(message)) {
+            Notify();
+            return true;
+        }
+        if (!keep_if_full) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        {
+            const std::lock_guard overflow_lock {overflow_mutex};
+            auto& queued_message = overflow.emplace_back();
+            std::ranges::copy(message, queued_message.data.begin());
+            queued_message.length = message.size();
+            overflowing.store(true, std::memory_order_release);
+        }
+        overflowed.fetch_add(1, std::memory_order_relaxed);
+        Notify();
+        return true;
+    }
+
+    // Take messages kept in the overflow once the queue is drained, only called by the consumer
+    bool TakeOverflow(std::vector<QueuedMessage>& messages_out) {
+        if (!overflowing.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const std::lock_guard overflow_lock {overflow_mutex};
+        std::swap(overflow, messages_out);
+        overflowing.store(false, std::memory_order_release);
+        return true;
+    }
+
+    // Pop message, only called by the consumer
+    bool TryPop(QueuedMessage& message) {
+        return messages.TryPop([&](const QueuedMessage& queued_message) {
+            std::copy_n(queued_message.data.begin(), queued_message.length, message.data.begin());
+            message.length = queued_message.length;
+        });
+    }
+
+    void Notify() {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+    }
+};
+
+struct cnstln::CHIRP::DiscoveredServicesSnapshot {
+    // Generation of the discovered services at which the snapshot was taken
+    std::uint64_t generation;
+
+    std::vector<DiscoveredService> services;
+};
+
+struct cnstln::CHIRP::LatencyRecorder {
+    struct Accumulator {
+        std::atomic_uint64_t count {0};
+        std::atomic_int64_t total {0};
+        std::atomic_int64_t max {0};
+
+        void Record(std::chrono::nanoseconds delay) {
+            const auto delay_ns = delay.count();
+            count.fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(delay_ns, std::memory_order_relaxed);
+            auto current_max = max.load(std::memory_order_relaxed);
+            while (delay_ns > current_max && !max.compare_exchange_weak(current_max, delay_ns, std::memory_order_relaxed)) {
+            }
+        }
+
+        LatencyStats Get() const {
+            return {count.load(std::memory_order_relaxed),
+                    std::chrono::nanoseconds(total.load(std::memory_order_relaxed)),
+                    std::chrono::nanoseconds(max.load(std::memory_order_relaxed))};
+        }
+
+        void Reset() {
+            count.store(0, std::memory_order_relaxed);
+            total.store(0, std::memory_order_relaxed);
+            max.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    Accumulator queue;
+    Accumulator dispatch;
+};
+
+// Fixed number of threads running discovery callbacks, each draining its own queue. Callbacks for the same service are
+// always queued to the same thread such that they run in the order of the broadcasts.
+struct cnstln::CHIRP::CallbackPool {
+    // Either a discovery callback for a single event or a batch callback
+    struct Task {
+        DiscoverCallback* callback;
+        DiscoveredService service;
+        bool depart;
+        std::any user_data;
+        std::chrono::steady_clock::time_point handle_time;
+        DiscoverBatchCallback* batch_callback;
+        std::vector<DiscoverEvent> events;
+    };
+
+    struct Worker {
+        BoundedQueue<Task, CALLBACK_QUEUE_CAPACITY> tasks;
+
+        // Incremented after each push to wake up the worker
+        std::atomic_uint64_t signal {0};
+
+        // Incremented after each pop to wake up a caller waiting for a free slot
+        std::atomic_uint64_t consumed {0};
+
+        std::jthread thread;
+    };
+
+    std::shared_ptr<LatencyRecorder> latency_recorder;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    CallbackPool(std::size_t threads, std::shared_ptr<LatencyRecorder> recorder) : latency_recorder(std::move(recorder)) {
+        workers.reserve(threads);
+        for (std::size_t n = 0; n < threads; ++n) {
+            auto& worker = *workers.emplace_back(std::make_unique<Worker>());
+            worker.thread = std::jthread(std::bind_front(&CallbackPool::Run, this), std::ref(worker));
+        }
+    }
+
+    // Run queued callbacks before stopping
+    ~CallbackPool() {
+        for (auto& worker : workers) {
+            worker->thread.request_stop();
+            Notify(*worker);
+        }
+        for (auto& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    CallbackPool(const CallbackPool&) = delete;
+    CallbackPool& operator=(const CallbackPool&) = delete;
+
+    // Queue callback to the thread of the service, blocks while its queue is full thus must not be called while holding a
+    // lock which callbacks might acquire
+    void Push(DiscoverCallback* callback,
+              const DiscoveredService& service,
+              bool depart,
+              const std::any& user_data,
+              std::chrono::steady_clock::time_point handle_time) {
+        auto& worker = *workers[std::hash<DiscoveredService>()(service) % workers.size()];
+        const auto fill = [&](Task& task) { task = {callback, service, depart, user_data, handle_time, nullptr, {}}; };
+        PushTask(worker, fill);
+    }
+
+    // Queue batch callback to the thread of the callback, blocks while its queue is full thus must not be called while
+    // holding a lock which callbacks might acquire
+    void PushBatch(DiscoverBatchCallback* callback,
+                   std::vector<DiscoverEvent>&& events,
+                   const std::any& user_data,
+                   std::chrono::steady_clock::time_point handle_time) {
+        auto& worker = *workers[std::hash<DiscoverBatchCallback*>()(callback) % workers.size()];
+        const auto fill = [&](Task& task) { task = {nullptr, {}, false, user_data, handle_time, callback, std::move(events)}; };
+        PushTask(worker, fill);
+    }
+
+    // Push task to the queue of the worker, waits without polling until the worker pops a task while the queue is full
+    template <typename Fill> static void PushTask(Worker& worker, Fill&& fill) {
+        while (true) {
+            // Load counter before pushing such that a pop after a failed push wakes up the wait
+            const auto consumed = worker.consumed.load(std::memory_order_acquire);
+            if (worker.tasks.TryPush(fill)) {
+                break;
+            }
+            worker.consumed.wait(consumed, std::memory_order_acquire);
+        }
+        Notify(worker);
+    }
+
+    void Run(const std::stop_token& stop_token, Worker& worker) {
+        Task task {};
+        while (true) {
+            // Load signal before draining such that a push after draining wakes up the wait
+            const auto signal = worker.signal.load(std::memory_order_acquire);
+
+            bool popped = false;
+            while (worker.tasks.TryPop([&](Task& queued_task) { task = std::move(queued_task); })) {
+                popped = true;
+                worker.consumed.fetch_add(1, std::memory_order_release);
+                worker.consumed.notify_one();
+                latency_recorder->dispatch.Record(std::chrono::steady_clock::now() - task.handle_time);
+                if (task.batch_callback != nullptr) {
+                    task.batch_callback(task.events, std::move(task.user_data));
+                }
+                else {
+                    task.callback(std::move(task.service), task.depart, std::move(task.user_data));
+                }
+            }
+            if (popped) {
+                continue;
+            }
+
+            // Queue drained, stop or wait for next push
+            if (stop_token.stop_requested()) {
+                break;
+            }
+            worker.signal.wait(signal, std::memory_order_acquire);
+        }
+    }
+
+    static void Notify(Worker& worker) {
+        worker.signal.fetch_add(1, std::memory_order_release);
+        worker.signal.notify_one();
+    }
+};
+
 bool RegisteredService::operator<(const RegisteredService& other) const {
     // Sort first by service id
     auto ord_id = std::to_underlying(identifier) <=> std::to_underlying(other.identifier);
@@ -47,213 +382,1452 @@ bool DiscoveredService::operator<(const DiscoveredService& other) const {
     return port < other.port;
 }
 
-bool DiscoverCallbackEntry::operator<(const DiscoverCallbackEntry& other) const {
-    // First sort after callback address
-    auto ord_callback = reinterpret_cast<std::uintptr_t>(callback) <=> reinterpret_cast<std::uintptr_t>(other.callback);
-    if (std::is_lt(ord_callback)) {
-        return true;
-    }
-    if (std::is_gt(ord_callback)) {
-        return false;
-    }
-    // Then after service identifier to listen to
-    return std::to_underlying(service_id) < std::to_underlying(other.service_id);
+bool DiscoveredService::operator==(const DiscoveredService& other) const {
+    // Same as DiscoveredService::operator<, ignore IP
+    return host_id == other.host_id && identifier == other.identifier && port == other.port;
 }
 
-Manager::Manager(asio::ip::address brd_address, asio::ip::address any_address, std::string_view group_name, std::string_view host_name)
-  : receiver_(any_address), sender_(brd_address), group_id_(MD5Hash(group_name)), host_id_(MD5Hash(host_name)) {}
+DiscoveredServiceTable::DiscoveredServiceTable(std::size_t change_capacity) : changes_(change_capacity) {}
 
-Manager::Manager(std::string_view brd_ip, std::string_view any_ip, std::string_view group_name, std::string_view host_name)
-  : Manager(asio::ip::make_address(brd_ip), asio::ip::make_address(any_ip), group_name, host_name) {}
+bool DiscoveredServiceTable::Insert(const DiscoveredService& service) {
+    return Emplace(service).second;
+}
 
-Manager::~Manager() {
-    // First stop Run function
-    run_thread_.request_stop();
-    if (run_thread_.joinable()) {
-        run_thread_.join();
+bool DiscoveredServiceTable::Refresh(const DiscoveredService& service, std::uint64_t expiry) {
+    const auto [index, inserted] = Emplace(service);
+    auto& entry = entries_[index];
+    if (entry.timer == TimingWheel::NO_TIMER) {
+        entry.timer = timers_.Add(expiry, index);
     }
-    // Now unregister all services
-    UnregisterServices();
+    else {
+        timers_.Reschedule(entry.timer, expiry);
+    }
+    return inserted;
 }
 
-void Manager::Start() {
-    // jthread immediatly starts on construction
-    run_thread_ = std::jthread(std::bind_front(&Manager::Run, this));
+void DiscoveredServiceTable::Expire(std::uint64_t tick, std::vector<DiscoveredService>& expired) {
+    timers_.Advance(tick, [&](std::uint32_t index) {
+        // Timer is already removed
+        entries_[index].timer = TimingWheel::NO_TIMER;
+        expired.push_back(entries_[index].service);
+        Erase(expired.back());
+    });
 }
 
-bool Manager::RegisterService(ServiceIdentifier service_id, Port port) {
-    RegisteredService service {service_id, port};
+void DiscoveredServiceTable::ClearExpiries() {
+    for (auto& entry : entries_) {
+        entry.timer = TimingWheel::NO_TIMER;
+    }
+    timers_.Clear();
+}
 
-    std::unique_lock registered_services_lock {registered_services_mutex_};
-    const auto insert_ret = registered_services_.insert(service);
-    const bool actually_inserted = insert_ret.second;
+std::pair<std::uint32_t, bool> DiscoveredServiceTable::Emplace(const DiscoveredService& service) {
+    // Keep load factor below one half such that probe sequences stay short
+    if (2 * (entries_.size() + 1) > slots_.size()) {
+        Grow();
+    }
 
-    // Lock not needed anymore
-    registered_services_lock.unlock();
-    if (actually_inserted) {
-        SendMessage(OFFER, service);
+    const auto hash = std::hash<DiscoveredService>()(service);
+    auto& slot = slots_[FindSlot(service, hash)];
+    if (slot.entry != 0) {
+        return {slot.entry - 1, false};
     }
-    return actually_inserted;
+
+    auto& service_index = service_indices_[std::to_underlying(service.identifier)];
+    entries_.push_back({service, hash, static_cast<std::uint32_t>(service_index.size())});
+    ++host_services_[service.host_id];
+    service_index.push_back(static_cast<std::uint32_t>(entries_.size() - 1));
+    slot = {static_cast<std::uint32_t>(entries_.size()), static_cast<std::uint32_t>(hash)};
+    RecordChange(service, false);
+    return {static_cast<std::uint32_t>(entries_.size() - 1), true};
 }
 
-bool Manager::UnregisterService(ServiceIdentifier service_id, Port port) {
-    RegisteredService service {service_id, port};
+bool DiscoveredServiceTable::Erase(const DiscoveredService& service) {
+    if (slots_.empty()) {
+        return false;
+    }
 
-    std::unique_lock registered_services_lock {registered_services_mutex_};
-    const auto erase_ret = registered_services_.erase(service);
-    bool actually_erased = erase_ret > 0 ? true : false;
+    const auto mask = slots_.size() - 1;
+    auto hole = FindSlot(service, std::hash<DiscoveredService>()(service));
+    if (slots_[hole].entry == 0) {
+        return false;
+    }
+    const auto index = slots_[hole].entry - 1;
+    RecordChange(entries_[index].service, true);
+    if (entries_[index].timer != TimingWheel::NO_TIMER) {
+        timers_.Remove(entries_[index].timer);
+    }
 
-    // Lock not needed anymore
-    registered_services_lock.unlock();
-    if (actually_erased) {
-        SendMessage(DEPART, service);
+    // Remove from index by service identifier by moving the last service of the same identifier into its position
+    auto& service_index = service_indices_[std::to_underlying(service.identifier)];
+    const auto service_position = entries_[index].service_position;
+    service_index[service_position] = service_index.back();
+    entries_[service_index.back()].service_position = service_position;
+    service_index.pop_back();
+
+    const auto host_it = host_services_.find(service.host_id);
+    if (--host_it->second == 0) {
+        host_services_.erase(host_it);
     }
-    return actually_erased;
-}
 
-void Manager::UnregisterServices() {
-    const std::lock_guard registered_services_lock {registered_services_mutex_};
-    for (auto service : registered_services_) {
-        SendMessage(DEPART, service);
+    // Shift following slots of the probe sequence backwards instead of leaving a tombstone
+    for (auto next = (hole + 1) & mask; slots_[next].entry != 0; next = (next + 1) & mask) {
+        const auto home = slots_[next].hash & mask;
+        // Slot can only be moved if the hole lies between its home slot and its current slot
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
     }
-    registered_services_.clear();
-}
+    slots_[hole] = {};
 
-std::set<RegisteredService> Manager::GetRegisteredServices() {
-    const std::lock_guard registered_services_lock {registered_services_mutex_};
-    return registered_services_;
+    // Move last service into the freed position such that services stay contiguous
+    const auto last = static_cast<std::uint32_t>(entries_.size() - 1);
+    if (index != last) {
+        auto& moved = entries_[last];
+        auto slot = moved.hash & mask;
+        while (slots_[slot].entry != last + 1) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot].entry = index + 1;
+        service_indices_[std::to_underlying(moved.service.identifier)][moved.service_position] = index;
+        if (moved.timer != TimingWheel::NO_TIMER) {
+            timers_.SetValue(moved.timer, index);
+        }
+        entries_[index] = std::move(moved);
+    }
+    entries_.pop_back();
+    return true;
 }
 
-bool Manager::RegisterDiscoverCallback(DiscoverCallback* callback, ServiceIdentifier service_id, std::any user_data) {
-    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
-    const auto insert_ret = discover_callbacks_.emplace(callback, service_id, user_data);
-
-    // Return if actually inserted
-    return insert_ret.second;
+bool DiscoveredServiceTable::Contains(const DiscoveredService& service) const {
+    if (slots_.empty()) {
+        return false;
+    }
+    return slots_[FindSlot(service, std::hash<DiscoveredService>()(service))].entry != 0;
 }
 
-bool Manager::UnregisterDiscoverCallback(DiscoverCallback* callback, ServiceIdentifier service_id) {
-    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
-    const auto erase_ret = discover_callbacks_.erase({callback, service_id, {}});
-
-    // Return if actually erased
-    return erase_ret > 0;
+std::size_t DiscoveredServiceTable::CountServices(const MD5Hash& host_id) const {
+    const auto host_it = host_services_.find(host_id);
+    return host_it != host_services_.end() ? host_it->second : 0;
 }
 
-void Manager::UnregisterDiscoverCallbacks() {
-    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
-    discover_callbacks_.clear();
+void DiscoveredServiceTable::Clear() {
+    entries_.clear();
+    host_services_.clear();
+    std::ranges::fill(slots_, Slot());
+    for (auto& service_index : service_indices_) {
+        service_index.clear();
+    }
+    timers_.Clear();
+    clear_generation_ = ++generation_;
 }
 
-void Manager::ForgetDiscoveredServices() {
-    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
-    discovered_services_.clear();
+DiscoveredServiceChanges DiscoveredServiceTable::GetChanges(std::uint64_t generation) const {
+    DiscoveredServiceChanges ret {generation_, false, {}};
+    if (generation >= clear_generation_ && generation <= generation_ && generation_ - generation <= changes_.size()) {
+        ret.changes.reserve(generation_ - generation);
+        for (auto change = generation; change < generation_; ++change) {
+            ret.changes.push_back(changes_[change % changes_.size()]);
+        }
+    }
+    else {
+        // Changes were overwritten or cleared, list all services instead
+        ret.reset = true;
+        ret.changes.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            ret.changes.push_back({generation_, entry.service, false});
+        }
+    }
+    return ret;
 }
 
-std::vector<DiscoveredService> Manager::GetDiscoveredServices() {
+std::vector<DiscoveredService> DiscoveredServiceTable::GetServices() const {
     std::vector<DiscoveredService> ret {};
-    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
-    std::copy(discovered_services_.begin(), discovered_services_.end(), std::back_inserter(ret));
+    ret.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        ret.push_back(entry.service);
+    }
     return ret;
 }
 
-std::vector<DiscoveredService> Manager::GetDiscoveredServices(ServiceIdentifier service_id) {
+std::vector<DiscoveredService> DiscoveredServiceTable::GetServices(ServiceIdentifier service_id) const {
+    const auto& service_index = service_indices_[std::to_underlying(service_id)];
     std::vector<DiscoveredService> ret {};
-    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
-    for (const auto& discovered_service : discovered_services_) {
-        if (discovered_service.identifier == service_id) {
-            ret.push_back(discovered_service);
-        }
+    ret.reserve(service_index.size());
+    for (const auto index : service_index) {
+        ret.push_back(entries_[index].service);
     }
     return ret;
 }
 
-void Manager::SendRequest(ServiceIdentifier service) {
-    SendMessage(REQUEST, {service, 0});
+std::size_t DiscoveredServiceTable::FindSlot(const DiscoveredService& service, std::size_t hash) const {
+    const auto mask = slots_.size() - 1;
+    const auto hash_fragment = static_cast<std::uint32_t>(hash);
+    for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+        const auto& candidate = slots_[slot];
+        // Only compare services if the hash fragments match
+        if (candidate.entry == 0 || (candidate.hash == hash_fragment && entries_[candidate.entry - 1].service == service)) {
+            return slot;
+        }
+    }
 }
 
-void Manager::SendMessage(MessageType type, RegisteredService service) {
-    const auto asm_msg = Message(type, group_id_, host_id_, service.identifier, service.port).Assemble();
-    sender_.SendBroadcast(asm_msg.data(), asm_msg.size());
+void DiscoveredServiceTable::RecordChange(const DiscoveredService& service, bool depart) {
+    ++generation_;
+    if (!changes_.empty()) {
+        changes_[(generation_ - 1) % changes_.size()] = {generation_, service, depart};
+    }
 }
 
-void Manager::Run(std::stop_token stop_token) {
-    while (!stop_token.stop_requested()) {
-        try {
-            const auto raw_msg_opt = receiver_.AsyncRecvBroadcast(100ms);
+void DiscoveredServiceTable::Grow() {
+    slots_.assign(std::max<std::size_t>(16, 2 * slots_.size()), Slot());
+    const auto mask = slots_.size() - 1;
+    for (std::size_t index = 0; index < entries_.size(); ++index) {
+        auto slot = entries_[index].hash & mask;
+        while (slots_[slot].entry != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = {static_cast<std::uint32_t>(index + 1), static_cast<std::uint32_t>(entries_[index].hash)};
+    }
+}
 
-            // Check for timeout
-            if (!raw_msg_opt.has_value()) {
-                continue;
-            }
+bool DiscoverCallbackEntry::operator<(const DiscoverCallbackEntry& other) const {
+    // First sort after callback address
+    auto ord_callback = reinterpret_cast<std::uintptr_t>(callback) <=> reinterpret_cast<std::uintptr_t>(other.callback);
+    if (std::is_lt(ord_callback)) {
+        return true;
+    }
+    if (std::is_gt(ord_callback)) {
+        return false;
+    }
+    // Then after service identifier to listen to
+    return std::to_underlying(service_id) < std::to_underlying(other.service_id);
+}
 
-            const auto raw_msg = raw_msg_opt.value();
-            auto chirp_msg = Message(AssembledMessage(raw_msg.content));
+DiscoverEventStream::DiscoverEventStream(asio::any_io_executor executor)
+  : signal_(std::move(executor), asio::steady_timer::time_point::max()) {}
 
-            if (chirp_msg.GetGroupID() != group_id_) {
-                // Broadcast from different group, ignore
-                continue;
+asio::awaitable<std::optional<DiscoverEvent>> DiscoverEventStream::Next() {
+    while (true) {
+        // Rearm signal before checking queue such that a notification in between is not lost
+        signal_.expires_at(asio::steady_timer::time_point::max());
+        {
+            const std::lock_guard events_lock {events_mutex_};
+            if (!events_.empty()) {
+                auto event = std::move(events_.front());
+                events_.pop_front();
+                co_return event;
             }
-            if (chirp_msg.GetHostID() == host_id_) {
-                // Broadcast from self, ignore
-                continue;
+            if (closed_) {
+                co_return std::nullopt;
             }
+        }
+        // Wait until signal expires or is cancelled
+        asio::error_code error {};
+        co_await signal_.async_wait(asio::redirect_error(asio::use_awaitable, error));
+    }
+}
 
-            DiscoveredService discovered_service {raw_msg.address, chirp_msg.GetHostID(), chirp_msg.GetServiceIdentifier(), chirp_msg.GetPort()};
+void DiscoverEventStream::Close() {
+    {
+        const std::lock_guard events_lock {events_mutex_};
+        closed_ = true;
+    }
+    Notify();
+}
 
-            switch (chirp_msg.GetType()) {
-            case REQUEST: {
-                auto service_id = discovered_service.identifier;
-                const std::lock_guard registered_services_lock {registered_services_mutex_};
-                // Replay OFFERs for registered services with same service identifier
-                for (const auto& service : registered_services_) {
-                    if (service.identifier == service_id) {
-                        SendMessage(OFFER, service);
-                    }
-                }
-                break;
-            }
-            case OFFER: {
-                std::unique_lock discovered_services_lock {discovered_services_mutex_};
-                if (!discovered_services_.contains(discovered_service)) {
-                    discovered_services_.insert(discovered_service);
-
-                    // Unlock discovered_services_lock for user callback
-                    discovered_services_lock.unlock();
-                    // Acquire lock for discover_callbacks_
-                    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
-                    // Loop over callback and run as detached threads
-                    for (const auto& cb_entry : discover_callbacks_) {
-                        if (cb_entry.service_id == discovered_service.identifier) {
-                            std::thread(cb_entry.callback, discovered_service, false, cb_entry.user_data).detach();
-                        }
-                    }
-                }
-                break;
-            }
-            case DEPART: {
-                std::unique_lock discovered_services_lock {discovered_services_mutex_};
-                if (discovered_services_.contains(discovered_service)) {
-                    discovered_services_.erase(discovered_service);
-
-                    // Unlock discovered_services_lock for user callback
-                    discovered_services_lock.unlock();
-                    // Acquire lock for discover_callbacks_
-                    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
-                    // Loop over callback and run as detached threads
-                    for (const auto& cb_entry : discover_callbacks_) {
-                        if (cb_entry.service_id == discovered_service.identifier) {
-                            std::thread(cb_entry.callback, discovered_service, true, cb_entry.user_data).detach();
-                        }
-                    }
-                }
-                break;
-            }
-            default: std::unreachable();
-            }
+void DiscoverEventStream::Push(DiscoverEvent event) {
+    {
+        const std::lock_guard events_lock {events_mutex_};
+        events_.push_back(std::move(event));
+    }
+    Notify();
+}
+
+void DiscoverEventStream::Notify() {
+    // Timer is not thread-safe, expire it on its executor
+    asio::post(signal_.get_executor(), [stream = shared_from_this()]() {
+        stream->signal_.expires_at(asio::steady_timer::time_point::min());
+    });
+}
+
+Manager::Manager(asio::ip::address brd_address, asio::ip::address any_address, std::string_view group_name, std::string_view host_name)
+  : any_address_(std::move(any_address)), send_queue_(std::make_unique<SendQueue>()),
+    group_id_(MD5Hash(group_name)), host_id_(MD5Hash(host_name)), latency_recorder_(std::make_shared<LatencyRecorder>()),
+    discovered_services_snapshot_(std::make_shared<const DiscoveredServicesSnapshot>()),
+    callback_threads_(DEFAULT_CALLBACK_THREADS) {
+    senders_.push_back(std::make_unique<BroadcastSend>(brd_address));
+    if (brd_address.is_multicast()) {
+        multicast_address_ = std::move(brd_address);
+    }
+    {
+        const std::lock_guard receiver_lock {receiver_mutex_};
+        receivers_.push_back(CreateReceiver());
+    }
+    send_thread_ = std::jthread(std::bind_front(&Manager::SendLoop, this));
+}
+
+Manager::Manager(std::string_view brd_ip, std::string_view any_ip, std::string_view group_name, std::string_view host_name)
+  : Manager(asio::ip::make_address(brd_ip), asio::ip::make_address(any_ip), group_name, host_name) {}
+
+Manager::Manager(const asio::ip::address& multicast_address, std::string_view group_name, std::string_view host_name)
+  : Manager(multicast_address,
+            multicast_address.is_v4() ? asio::ip::address(asio::ip::address_v4::any()) : asio::ip::address(asio::ip::address_v6::any()),
+            group_name,
+            host_name) {}
+
+Manager::Manager(std::string_view multicast_ip, std::string_view group_name, std::string_view host_name)
+  : Manager(asio::ip::make_address(multicast_ip), group_name, host_name) {}
+
+Manager::Manager(std::span<const NetworkInterface> interfaces, std::string_view group_name, std::string_view host_name)
+  : Manager(asio::ip::address_v4::broadcast(), asio::ip::address_v4::any(), group_name, host_name) {
+    if (interfaces.empty()) {
+        return;
+    }
+
+    // Replace sender with one sender per interface
+    {
+        const std::lock_guard sender_lock {sender_mutex_};
+        senders_.clear();
+        for (const auto& network_interface : interfaces) {
+            senders_.push_back(std::make_unique<BroadcastSend>(network_interface.broadcast_address));
+            interface_indices_.push_back(network_interface.index);
         }
-        catch (const DecodeError& error) {
-            continue;
+    }
+
+    // Receive interface index alongside incoming broadcasts
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    for (auto& receiver : receivers_) {
+        receiver->EnablePacketInfo();
+    }
+}
+
+Manager::Manager(std::string_view group_name, std::string_view host_name)
+  : Manager(GetNetworkInterfaces(), group_name, host_name) {}
+
+Manager::~Manager() {
+    // First stop Run functions, request all stops before joining such that threads stop in parallel
+    for (auto& run_thread : run_threads_) {
+        run_thread.request_stop();
+    }
+    for (auto& run_thread : run_threads_) {
+        if (run_thread.joinable()) {
+            run_thread.join();
         }
     }
+    // Stop broadcasting scheduled replies
+    if (reply_thread_.joinable()) {
+        reply_thread_.request_stop();
+        reply_thread_.join();
+    }
+    // Stop expiring services
+    if (expiry_thread_.joinable()) {
+        expiry_thread_.request_stop();
+        expiry_thread_.join();
+    }
+    // Pass remaining batches and run remaining callbacks
+    if (batch_thread_.joinable()) {
+        batch_thread_.request_stop();
+        batch_thread_.join();
+    }
+    callback_pool_.reset();
+
+    // Now unregister all services
+    UnregisterServices();
+
+    // Stop sending after queued broadcasts are sent
+    send_thread_.request_stop();
+    send_queue_->Notify();
+    send_thread_.join();
+
+    // Close all subscribed discovery event streams
+    for (const auto& weak_stream : discover_streams_) {
+        if (auto stream = weak_stream.lock()) {
+            stream->Close();
+        }
+    }
+}
+
+void Manager::Start(std::size_t recv_threads) {
+    // Stop already running threads
+    run_threads_.clear();
+
+    // Open one socket per thread if number of threads changed
+    recv_threads = std::max<std::size_t>(recv_threads, 1);
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    if (receivers_.size() != recv_threads) {
+        receivers_.clear();
+        const bool reuse_port = recv_threads > 1;
+        for (std::size_t n = 0; n < recv_threads; ++n) {
+            receivers_.push_back(CreateReceiver(reuse_port));
+        }
+        // Spread incoming broadcasts by host ID, fall back to single socket if not supported
+        for (std::size_t n = 0; n < recv_threads; ++n) {
+            if (!receivers_[n]->SetShard(MessageView::HOST_ID_OFFSET, n, recv_threads)) {
+                receivers_.clear();
+                receivers_.push_back(CreateReceiver());
+                break;
+            }
+        }
+    }
+
+    // jthread immediatly starts on construction
+    for (auto& receiver : receivers_) {
+        run_threads_.emplace_back(std::bind_front(&Manager::Run, this), std::ref(*receiver));
+    }
+}
+
+bool Manager::EnableKernelFilter() {
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    kernel_filter_ = true;
+    bool attached = true;
+    for (auto& receiver : receivers_) {
+        attached = AttachKernelFilter(*receiver) && attached;
+    }
+    return attached;
+}
+
+void Manager::SetReceiveBufferSize(std::size_t size) {
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    receive_buffer_size_ = size;
+    for (auto& receiver : receivers_) {
+        receiver->SetReceiveBufferSize(size);
+    }
+}
+
+void Manager::SetSendBufferSize(std::size_t size) {
+    const std::lock_guard sender_lock {sender_mutex_};
+    for (auto& sender : senders_) {
+        sender->SetSendBufferSize(size);
+    }
+}
+
+BroadcastRecvStats Manager::GetRecvStats() {
+    BroadcastRecvStats stats {};
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    for (const auto& receiver : receivers_) {
+        const auto receiver_stats = receiver->GetStats();
+        stats.kernel_drops += receiver_stats.kernel_drops;
+        stats.filter_drops += receiver_stats.filter_drops;
+        stats.oversized += receiver_stats.oversized;
+        stats.syscalls += receiver_stats.syscalls;
+    }
+    return stats;
+}
+
+bool Manager::EnableIoUring() {
+    // Receive chains have to be restarted to wait for the buffer ring instead of the socket
+    const auto recv_threads = run_threads_.size();
+    run_threads_.clear();
+
+    bool enabled = true;
+    {
+        const std::lock_guard receiver_lock {receiver_mutex_};
+        io_uring_ = true;
+        for (auto& receiver : receivers_) {
+            enabled = receiver->EnableIoUring() && enabled;
+        }
+    }
+    {
+        const std::lock_guard sender_lock {sender_mutex_};
+        for (auto& sender : senders_) {
+            enabled = sender->EnableIoUring() && enabled;
+        }
+    }
+
+    if (recv_threads > 0) {
+        Start(recv_threads);
+    }
+    return enabled;
+}
+
+bool Manager::EnableTimestamps() {
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    timestamps_ = true;
+    bool enabled = true;
+    for (auto& receiver : receivers_) {
+        enabled = receiver->EnableTimestamps() && enabled;
+    }
+    return enabled;
+}
+
+DiscoverLatencyStats Manager::GetLatencyStats() {
+    return {latency_recorder_->queue.Get(), latency_recorder_->dispatch.Get()};
+}
+
+void Manager::ResetLatencyStats() {
+    latency_recorder_->queue.Reset();
+    latency_recorder_->dispatch.Reset();
+}
+
+void Manager::SetReplyJitter(std::chrono::steady_clock::duration jitter) {
+    {
+        const std::lock_guard reply_lock {reply_mutex_};
+        reply_jitter_ = jitter;
+    }
+    // Start reply thread on first use
+    if (jitter > std::chrono::steady_clock::duration::zero() && !reply_thread_.joinable()) {
+        reply_thread_ = std::jthread(std::bind_front(&Manager::ReplyLoop, this));
+    }
+}
+
+void Manager::SetReplyHoldOff(std::chrono::steady_clock::duration hold_off) {
+    const std::lock_guard reply_lock {reply_mutex_};
+    reply_hold_off_ = hold_off;
+}
+
+void Manager::EnableProtocolV2() {
+    protocol_v2_.store(true, std::memory_order_relaxed);
+
+    // Replace kernel-level filter such that CHIRP v2 messages pass
+    const std::lock_guard receiver_lock {receiver_mutex_};
+    if (kernel_filter_) {
+        for (auto& receiver : receivers_) {
+            AttachKernelFilter(*receiver);
+        }
+    }
+}
+
+bool Manager::UsesProtocolV2() const {
+    return send_v2_.load(std::memory_order_relaxed);
+}
+
+SendStats Manager::GetSendStats() {
+    return {send_queue_->messages.Pushed() + send_queue_->overflowed.load(std::memory_order_relaxed),
+            send_queue_->sent.load(std::memory_order_relaxed),
+            send_queue_->failed.load(std::memory_order_relaxed),
+            send_queue_->dropped.load(std::memory_order_relaxed)};
+}
+
+ReplyStats Manager::GetReplyStats() {
+    const std::lock_guard reply_lock {reply_mutex_};
+    return reply_stats_;
+}
+
+bool Manager::RegisterService(ServiceIdentifier service_id, Port port) {
+    RegisteredService service {service_id, port};
+
+    // Assemble OFFER once, replayed for every REQUEST
+    const auto asm_msg = Message(OFFER, group_id_, host_id_, service_id, port).Assemble();
+
+    std::unique_lock registered_services_lock {registered_services_mutex_};
+    const auto insert_ret = registered_services_.try_emplace(service, asm_msg);
+    const bool actually_inserted = insert_ret.second;
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    if (actually_inserted) {
+        send_queue_->Push(asm_msg, false);
+    }
+    return actually_inserted;
+}
+
+bool Manager::UnregisterService(ServiceIdentifier service_id, Port port) {
+    RegisteredService service {service_id, port};
+
+    std::unique_lock registered_services_lock {registered_services_mutex_};
+    const auto erase_ret = registered_services_.erase(service);
+    bool actually_erased = erase_ret > 0 ? true : false;
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    if (actually_erased) {
+        SendMessage(DEPART, service);
+    }
+    return actually_erased;
+}
+
+std::size_t Manager::RegisterServices(std::span<const RegisteredService> services) {
+    std::vector<RegisteredService> inserted_services {};
+    std::vector<AssembledMessage> offers {};
+    inserted_services.reserve(services.size());
+    offers.reserve(services.size());
+
+    std::unique_lock registered_services_lock {registered_services_mutex_};
+    for (const auto& service : services) {
+        const auto asm_msg = Message(OFFER, group_id_, host_id_, service.identifier, service.port).Assemble();
+        if (registered_services_.try_emplace(service, asm_msg).second) {
+            inserted_services.push_back(service);
+            offers.push_back(asm_msg);
+        }
+    }
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    if (send_v2_.load(std::memory_order_relaxed)) {
+        SendPackedMessages(OFFER, inserted_services);
+    }
+    else {
+        for (const auto& asm_msg : offers) {
+            send_queue_->Push(asm_msg, false);
+        }
+    }
+    return offers.size();
+}
+
+std::size_t Manager::UnregisterServices(std::span<const RegisteredService> services) {
+    std::vector<RegisteredService> erased_services {};
+    erased_services.reserve(services.size());
+
+    std::unique_lock registered_services_lock {registered_services_mutex_};
+    for (const auto& service : services) {
+        if (registered_services_.erase(service) > 0) {
+            erased_services.push_back(service);
+        }
+    }
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    if (send_v2_.load(std::memory_order_relaxed)) {
+        SendPackedMessages(DEPART, erased_services);
+    }
+    else {
+        SendMessages(DEPART, erased_services);
+    }
+    return erased_services.size();
+}
+
+void Manager::UnregisterServices() {
+    std::unique_lock registered_services_lock {registered_services_mutex_};
+    std::vector<RegisteredService> erased_services {};
+    erased_services.reserve(registered_services_.size());
+    for (const auto& entry : registered_services_) {
+        erased_services.push_back(entry.first);
+    }
+    registered_services_.clear();
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    if (send_v2_.load(std::memory_order_relaxed)) {
+        SendPackedMessages(DEPART, erased_services);
+    }
+    else {
+        SendMessages(DEPART, erased_services);
+    }
+}
+
+std::set<RegisteredService> Manager::GetRegisteredServices() {
+    std::set<RegisteredService> services {};
+    const std::lock_guard registered_services_lock {registered_services_mutex_};
+    for (const auto& entry : registered_services_) {
+        services.insert(services.end(), entry.first);
+    }
+    return services;
+}
+
+void Manager::SetCallbackThreads(std::size_t threads) {
+    std::shared_ptr<CallbackPool> old_callback_pool {};
+    {
+        const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+        callback_threads_ = std::max<std::size_t>(threads, 1);
+        if (callback_pool_ != nullptr) {
+            old_callback_pool = std::exchange(callback_pool_, std::make_shared<CallbackPool>(callback_threads_, latency_recorder_));
+        }
+    }
+    // Run callbacks queued to the old threads without locking such that they can access the manager, threads still queueing
+    // to the old threads share ownership and stop them when done
+    old_callback_pool.reset();
+}
+
+bool Manager::RegisterDiscoverCallback(DiscoverCallback* callback, ServiceIdentifier service_id, std::any user_data) {
+    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+    const auto insert_ret = discover_callbacks_.emplace(callback, service_id, user_data);
+
+    // Start callback threads with first callback
+    if (callback_pool_ == nullptr) {
+        callback_pool_ = std::make_shared<CallbackPool>(callback_threads_, latency_recorder_);
+    }
+
+    // Return if actually inserted
+    return insert_ret.second;
+}
+
+bool Manager::UnregisterDiscoverCallback(DiscoverCallback* callback, ServiceIdentifier service_id) {
+    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+    const auto erase_ret = discover_callbacks_.erase({callback, service_id, {}});
+
+    // Return if actually erased
+    return erase_ret > 0;
+}
+
+bool Manager::RegisterDiscoverBatchCallback(DiscoverBatchCallback* callback,
+                                            ServiceIdentifier service_id,
+                                            std::any user_data,
+                                            std::chrono::steady_clock::duration window,
+                                            std::size_t max_events) {
+    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+    const std::lock_guard batch_callbacks_lock {batch_callbacks_mutex_};
+    const auto registered = std::ranges::any_of(batch_callbacks_, [&](const auto& state) {
+        return state.callback == callback && state.service_id == service_id;
+    });
+    if (registered) {
+        return false;
+    }
+    batch_callbacks_.push_back({callback, service_id, std::move(user_data), window, std::max<std::size_t>(max_events, 1), {}, {}});
+
+    // Start callback threads and batch thread with first batch callback
+    if (callback_pool_ == nullptr) {
+        callback_pool_ = std::make_shared<CallbackPool>(callback_threads_, latency_recorder_);
+    }
+    if (!batch_thread_.joinable()) {
+        batch_thread_ = std::jthread(std::bind_front(&Manager::BatchLoop, this));
+    }
+    return true;
+}
+
+bool Manager::UnregisterDiscoverBatchCallback(DiscoverBatchCallback* callback, ServiceIdentifier service_id) {
+    const std::lock_guard batch_callbacks_lock {batch_callbacks_mutex_};
+    const auto erased = std::erase_if(batch_callbacks_, [&](const auto& state) {
+        return state.callback == callback && state.service_id == service_id;
+    });
+    return erased > 0;
+}
+
+void Manager::UnregisterDiscoverCallbacks() {
+    {
+        const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+        discover_callbacks_.clear();
+    }
+    const std::lock_guard batch_callbacks_lock {batch_callbacks_mutex_};
+    batch_callbacks_.clear();
+}
+
+std::shared_ptr<DiscoverEventStream> Manager::SubscribeDiscoverEvents(asio::any_io_executor executor) {
+    auto stream = std::make_shared<DiscoverEventStream>(std::move(executor));
+
+    const std::lock_guard discover_callbacks_lock {discover_callbacks_mutex_};
+    // Remove unsubscribed streams
+    std::erase_if(discover_streams_, [](const auto& weak_stream) { return weak_stream.expired(); });
+    discover_streams_.push_back(stream);
+
+    return stream;
+}
+
+void Manager::ForgetDiscoveredServices() {
+    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+    discovered_services_.Clear();
+    discovered_services_generation_.store(discovered_services_.GetGeneration(), std::memory_order_release);
+    PublishDiscoveredServices();
+    peer_versions_.clear();
+    v1_peers_ = 0;
+    UpdateSendV2();
+}
+
+void Manager::SetServiceTTL(std::chrono::steady_clock::duration ttl) {
+    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+    service_ttl_ = ttl;
+    if (ttl <= std::chrono::steady_clock::duration::zero()) {
+        discovered_services_.ClearExpiries();
+        return;
+    }
+
+    // Refresh all discovered services with new time to live
+    const auto expiry = GetExpiryTick(std::chrono::steady_clock::now() + ttl) + 1;
+    for (const auto& service : discovered_services_.GetServices()) {
+        discovered_services_.Refresh(service, expiry);
+    }
+
+    // Start expiry thread on first use
+    if (!expiry_thread_.joinable()) {
+        expiry_thread_ = std::jthread(std::bind_front(&Manager::ExpiryLoop, this));
+    }
+    ScheduleExpiry();
+}
+
+std::vector<DiscoveredService> Manager::GetDiscoveredServices() {
+    return discovered_services_snapshot_.load(std::memory_order_acquire)->services;
+}
+
+std::shared_ptr<const std::vector<DiscoveredService>> Manager::GetDiscoveredServicesSnapshot() {
+    auto snapshot = discovered_services_snapshot_.load(std::memory_order_acquire);
+    // Share ownership of the snapshot with the returned vector
+    return {snapshot, &snapshot->services};
+}
+
+std::uint64_t Manager::GetDiscoveredServicesGeneration() const {
+    return discovered_services_generation_.load(std::memory_order_acquire);
+}
+
+DiscoveredServiceChanges Manager::GetDiscoveredServiceChanges(std::uint64_t generation) {
+    // Avoid locking if nothing changed
+    if (generation == discovered_services_generation_.load(std::memory_order_acquire)) {
+        return {generation, false, {}};
+    }
+    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+    return discovered_services_.GetChanges(generation);
+}
+
+std::vector<DiscoveredService> Manager::GetDiscoveredServices(ServiceIdentifier service_id) {
+    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+    return discovered_services_.GetServices(service_id);
+}
+
+void Manager::SendRequest(ServiceIdentifier service) {
+    // Port of REQUESTs is unused in CHIRP v1, announce highest supported CHIRP version instead
+    const Port version = protocol_v2_.load(std::memory_order_relaxed) ? CHIRP_VERSION_2 : 0;
+    SendMessage(REQUEST, {service, version});
+}
+
+void Manager::SendOffers(ServiceIdentifier service_id) {
+    // Reused by each replying thread such that steady-state replies do not allocate
+    thread_local std::vector<AssembledMessage> offers {};
+    offers.clear();
+    std::shared_lock registered_services_lock {registered_services_mutex_};
+    // Registered services are sorted by service identifier first, replay their pre-assembled OFFERs
+    for (auto it = registered_services_.lower_bound({service_id, 0});
+         it != registered_services_.end() && it->first.identifier == service_id;
+         ++it) {
+        offers.push_back(it->second);
+    }
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    for (const auto& asm_msg : offers) {
+        send_queue_->Push(asm_msg, false);
+    }
+}
+
+void Manager::SendPackedOffers() {
+    std::vector<RegisteredService> services {};
+    std::shared_lock registered_services_lock {registered_services_mutex_};
+    services.reserve(registered_services_.size());
+    for (const auto& entry : registered_services_) {
+        services.push_back(entry.first);
+    }
+
+    // Lock not needed anymore
+    registered_services_lock.unlock();
+    SendPackedMessages(OFFER, services);
+}
+
+void Manager::HandleRequest(ServiceIdentifier service_id, std::uint8_t version) {
+    const auto now = std::chrono::steady_clock::now();
+
+    // Only the requesting host relies on the reply, thus CHIRP v2 can be used if it was announced in the REQUEST. Then
+    // all services are offered in one reply round, such that REQUESTs for any service are coalesced.
+    const bool packed = version >= CHIRP_VERSION_2 && protocol_v2_.load(std::memory_order_relaxed);
+    const auto reply_index = packed ? PACKED_REPLY : static_cast<std::size_t>(service_id);
+
+    std::unique_lock reply_lock {reply_mutex_};
+    ++reply_stats_.requests;
+    auto& state = reply_states_[reply_index];
+
+    // Fold into scheduled reply round
+    if (state.pending) {
+        ++reply_stats_.coalesced;
+        return;
+    }
+    // Skip if OFFERs were broadcast shortly before
+    if (state.last_reply != std::chrono::steady_clock::time_point() && now - state.last_reply < reply_hold_off_) {
+        ++reply_stats_.suppressed;
+        return;
+    }
+
+    if (reply_jitter_ > std::chrono::steady_clock::duration::zero()) {
+        // Schedule reply round after random delay
+        std::uniform_int_distribution<std::chrono::steady_clock::rep> distribution {0, reply_jitter_.count()};
+        state.pending = true;
+        state.deadline = now + std::chrono::steady_clock::duration(distribution(reply_random_));
+        ++reply_schedules_;
+        reply_lock.unlock();
+        reply_cv_.notify_one();
+        return;
+    }
+
+    // Reply immediately
+    ++reply_stats_.replies;
+    state.last_reply = now;
+    reply_lock.unlock();
+    if (reply_index == PACKED_REPLY) {
+        SendPackedOffers();
+    }
+    else {
+        SendOffers(service_id);
+    }
+}
+
+void Manager::ReplyLoop(const std::stop_token& stop_token) {
+    std::unique_lock reply_lock {reply_mutex_};
+    while (!stop_token.stop_requested()) {
+        // Find earliest scheduled reply round
+        auto next_deadline = std::chrono::steady_clock::time_point::max();
+        for (const auto& state : reply_states_) {
+            if (state.pending) {
+                next_deadline = std::min(next_deadline, state.deadline);
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (next_deadline > now) {
+            // Wait until due or a new reply round is scheduled
+            const auto schedules = reply_schedules_;
+            const auto rescheduled = [&] { return reply_schedules_ != schedules; };
+            if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+                reply_cv_.wait(reply_lock, stop_token, rescheduled);
+            }
+            else {
+                reply_cv_.wait_until(reply_lock, stop_token, next_deadline, rescheduled);
+            }
+            continue;
+        }
+
+        // Broadcast all due reply rounds
+        for (std::size_t n = 0; n < reply_states_.size(); ++n) {
+            auto& state = reply_states_[n];
+            if (state.pending && state.deadline <= now) {
+                state.pending = false;
+                state.last_reply = now;
+                ++reply_stats_.replies;
+
+                reply_lock.unlock();
+                if (n == PACKED_REPLY) {
+                    SendPackedOffers();
+                }
+                else {
+                    SendOffers(static_cast<ServiceIdentifier>(n));
+                }
+                reply_lock.lock();
+            }
+        }
+    }
+}
+
+void Manager::BatchLoop(const std::stop_token& stop_token) {
+    struct DueBatch {
+        DiscoverBatchCallback* callback;
+        std::vector<DiscoverEvent> events;
+        std::any user_data;
+        std::chrono::steady_clock::time_point handle_time;
+    };
+    std::vector<DueBatch> due_batches {};
+
+    std::unique_lock batch_callbacks_lock {batch_callbacks_mutex_};
+    while (true) {
+        // Collect due batches and find earliest deadline of the others, all batches are due when stopping
+        const bool stopping = stop_token.stop_requested();
+        const auto now = std::chrono::steady_clock::now();
+        auto next_deadline = std::chrono::steady_clock::time_point::max();
+        for (auto& state : batch_callbacks_) {
+            if (state.events.empty()) {
+                continue;
+            }
+            const auto deadline = state.handle_time + state.window;
+            if (stopping || state.events.size() >= state.max_events || deadline <= now) {
+                if (state.events.size() <= state.max_events) {
+                    due_batches.push_back({state.callback, std::exchange(state.events, {}), state.user_data, state.handle_time});
+                    continue;
+                }
+                // More events arrived before the batch thread woke up, split into batches of maximum size
+                for (std::size_t first = 0; first < state.events.size(); first += state.max_events) {
+                    const auto events = std::span(state.events).subspan(first, std::min(state.max_events, state.events.size() - first));
+                    due_batches.push_back({state.callback, {events.begin(), events.end()}, state.user_data, state.handle_time});
+                }
+                state.events.clear();
+            }
+            else {
+                next_deadline = std::min(next_deadline, deadline);
+            }
+        }
+
+        if (!due_batches.empty()) {
+            // Queue batches without holding any lock since a full queue only drains once its callbacks return, only this
+            // thread queues batches such that they stay in order
+            batch_callbacks_lock.unlock();
+            std::shared_ptr<CallbackPool> callback_pool {};
+            {
+                const std::shared_lock discover_callbacks_lock {discover_callbacks_mutex_};
+                callback_pool = callback_pool_;
+            }
+            for (auto& batch : due_batches) {
+                callback_pool->PushBatch(batch.callback, std::move(batch.events), batch.user_data, batch.handle_time);
+            }
+            due_batches.clear();
+            batch_callbacks_lock.lock();
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+
+        // Wait until due, a batch starts collecting or a batch is full
+        const auto schedules = batch_schedules_;
+        const auto rescheduled = [&] { return batch_schedules_ != schedules; };
+        if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+            batch_cv_.wait(batch_callbacks_lock, stop_token, rescheduled);
+        }
+        else {
+            batch_cv_.wait_until(batch_callbacks_lock, stop_token, next_deadline, rescheduled);
+        }
+    }
+}
+
+void Manager::ExpiryLoop(const std::stop_token& stop_token) {
+    std::vector<DiscoveredService> expired {};
+
+    std::unique_lock discovered_services_lock {discovered_services_mutex_};
+    while (!stop_token.stop_requested()) {
+        const auto now = std::chrono::steady_clock::now();
+        discovered_services_.Expire(GetExpiryTick(now), expired);
+        if (!expired.empty()) {
+            discovered_services_generation_.store(discovered_services_.GetGeneration(), std::memory_order_release);
+            PublishDiscoveredServices();
+            for (const auto& service : expired) {
+                QueueNotification(service, true, now);
+                PrunePeerVersion(service.host_id);
+            }
+            expired.clear();
+
+            // Unlock discovered_services_lock for user callback
+            discovered_services_lock.unlock();
+            DispatchNotifications();
+            discovered_services_lock.lock();
+            continue;
+        }
+
+        // Wait until next tick with expiring services or until a service expires earlier
+        const auto next_tick = discovered_services_.GetNextExpiryTick();
+        expiry_wake_tick_ = next_tick.value_or(std::numeric_limits<std::uint64_t>::max());
+        const auto schedules = expiry_schedules_;
+        const auto rescheduled = [&] { return expiry_schedules_ != schedules; };
+        if (!next_tick.has_value()) {
+            expiry_cv_.wait(discovered_services_lock, stop_token, rescheduled);
+        }
+        else {
+            const auto deadline = expiry_epoch_ + EXPIRY_TICK * next_tick.value();
+            expiry_cv_.wait_until(discovered_services_lock, stop_token, deadline, rescheduled);
+        }
+    }
+}
+
+std::uint64_t Manager::GetExpiryTick(std::chrono::steady_clock::time_point time) const {
+    return static_cast<std::uint64_t>((time - expiry_epoch_) / EXPIRY_TICK);
+}
+
+void Manager::PublishDiscoveredServices() {
+    const auto generation = discovered_services_.GetGeneration();
+    if (discovered_services_snapshot_.load(std::memory_order_relaxed)->generation != generation) {
+        discovered_services_snapshot_.store(std::make_shared<const DiscoveredServicesSnapshot>(generation, discovered_services_.GetServices()),
+                                            std::memory_order_release);
+    }
+}
+
+void Manager::ScheduleExpiry() {
+    const auto next_tick = discovered_services_.GetNextExpiryTick();
+    if (next_tick.has_value() && next_tick.value() < expiry_wake_tick_) {
+        expiry_wake_tick_ = next_tick.value();
+        ++expiry_schedules_;
+        expiry_cv_.notify_one();
+    }
+}
+
+void Manager::SendMessage(MessageType type, RegisteredService service) {
+    send_queue_->Push(Message(type, group_id_, host_id_, service.identifier, service.port).Assemble(), type == DEPART);
+}
+
+void Manager::SendMessages(MessageType type, std::span<const RegisteredService> services) {
+    for (const auto& service : services) {
+        SendMessage(type, service);
+    }
+}
+
+void Manager::SendPackedMessages(MessageType type, std::span<const RegisteredService> services) {
+    // Pack services into as few messages as possible
+    for (std::size_t offset = 0; offset < services.size(); offset += CHIRP_V2_MAX_SERVICES) {
+        MultiMessage multi_msg {type, group_id_, host_id_};
+        for (const auto& service : services.subspan(offset, std::min(CHIRP_V2_MAX_SERVICES, services.size() - offset))) {
+            multi_msg.AddService(service.identifier, service.port);
+        }
+        send_queue_->Push(multi_msg.Assemble(), type == DEPART);
+    }
+}
+
+void Manager::SendLoop(const std::stop_token& stop_token) {
+    std::array<SendQueue::QueuedMessage, SEND_BATCH_SIZE> asm_msgs {};
+    std::vector<SendQueue::QueuedMessage> overflow_msgs {};
+    std::array<asio::const_buffer, SEND_BATCH_SIZE> buffers {};
+    std::array<asio::error_code, SEND_BATCH_SIZE> errors {};
+    std::array<bool, SEND_BATCH_SIZE> delivered {};
+
+    const auto send_batch = [&](std::span<const SendQueue::QueuedMessage> batch_msgs) {
+        const auto batch = batch_msgs.size();
+        for (std::size_t n = 0; n < batch; ++n) {
+            buffers[n] = asio::buffer(batch_msgs[n].data.data(), batch_msgs[n].length);
+        }
+
+        // Send on every interface, an error on one interface does not prevent sending on the others
+        std::fill_n(delivered.begin(), batch, false);
+        {
+            const std::lock_guard sender_lock {sender_mutex_};
+            for (auto& sender : senders_) {
+                try {
+                    sender->TrySendBroadcasts(std::span(buffers).first(batch), std::span(errors).first(batch));
+                }
+                catch (const asio::system_error&) {
+                    // Submitting failed, messages sent on this interface are unknown
+                    continue;
+                }
+                for (std::size_t n = 0; n < batch; ++n) {
+                    delivered[n] = delivered[n] || !errors[n];
+                }
+            }
+        }
+
+        // Count each message once, as sent if it was sent on at least one interface
+        const auto sent = static_cast<std::uint64_t>(std::count(delivered.begin(), delivered.begin() + batch, true));
+        send_queue_->sent.fetch_add(sent, std::memory_order_relaxed);
+        send_queue_->failed.fetch_add(batch - sent, std::memory_order_relaxed);
+    };
+
+    while (true) {
+        // Load signal before draining such that a push after draining wakes up the wait
+        const auto signal = send_queue_->signal.load(std::memory_order_acquire);
+
+        std::size_t batch = 0;
+        while (batch < SEND_BATCH_SIZE && send_queue_->TryPop(asm_msgs[batch])) {
+            ++batch;
+        }
+        if (batch > 0) {
+            send_batch(std::span(asm_msgs).first(batch));
+            continue;
+        }
+
+        // Queue drained, send messages kept while it was full, which were queued after all drained messages
+        if (send_queue_->TakeOverflow(overflow_msgs)) {
+            for (std::size_t offset = 0; offset < overflow_msgs.size(); offset += SEND_BATCH_SIZE) {
+                send_batch(std::span(overflow_msgs).subspan(offset, std::min(SEND_BATCH_SIZE, overflow_msgs.size() - offset)));
+            }
+            overflow_msgs.clear();
+            continue;
+        }
+
+        // Queue drained, stop or wait for next push
+        if (stop_token.stop_requested()) {
+            break;
+        }
+        send_queue_->signal.wait(signal, std::memory_order_acquire);
+    }
+}
+
+std::unique_ptr<BroadcastRecv> Manager::CreateReceiver(bool reuse_port) {
+    auto receiver = std::make_unique<BroadcastRecv>(any_address_, reuse_port);
+    if (multicast_address_.has_value()) {
+        receiver->JoinMulticastGroup(multicast_address_.value());
+    }
+    if (!interface_indices_.empty()) {
+        receiver->EnablePacketInfo();
+    }
+    if (kernel_filter_) {
+        AttachKernelFilter(*receiver);
+    }
+    if (receive_buffer_size_ > 0) {
+        receiver->SetReceiveBufferSize(receive_buffer_size_);
+    }
+    if (timestamps_) {
+        receiver->EnableTimestamps();
+    }
+    if (io_uring_) {
+        receiver->EnableIoUring();
+    }
+    return receiver;
+}
+
+bool Manager::AttachKernelFilter(BroadcastRecv& receiver) const {
+    if (!protocol_v2_.load(std::memory_order_relaxed)) {
+        // Match length, CHIRP header with version and group ID, see Message::Assemble
+        const std::vector<BroadcastFilterPattern> patterns {
+            {0, {'C', 'H', 'I', 'R', 'P', CHIRP_VERSION}},
+            {MessageView::GROUP_ID_OFFSET, {group_id_.cbegin(), group_id_.cend()}},
+        };
+        return receiver.AttachFilter(CHIRP_MESSAGE_LENGTH, patterns);
+    }
+    // Match CHIRP header and group ID only, version and length are checked when decoding such that both CHIRP v1 and
+    // CHIRP v2 messages pass
+    const std::vector<BroadcastFilterPattern> patterns {
+        {0, {'C', 'H', 'I', 'R', 'P'}},
+        {MessageView::GROUP_ID_OFFSET, {group_id_.cbegin(), group_id_.cend()}},
+    };
+    return receiver.AttachFilter(0, patterns);
+}
+
+void Manager::Run(std::stop_token stop_token, BroadcastRecv& receiver) {
+    // Storage for received messages, reused for every batch such that no allocations are required
+    std::array<std::array<std::uint8_t, CHIRP_V2_MAX_MESSAGE_LENGTH>, RECV_BATCH_SIZE> msgs {};
+    std::array<BroadcastBuffer, RECV_BATCH_SIZE> raw_msgs {};
+    for (std::size_t n = 0; n < RECV_BATCH_SIZE; ++n) {
+        raw_msgs[n].buffer = msgs[n];
+    }
+
+    receiver.StartRecvBroadcasts(raw_msgs, [&](std::size_t received) {
+        // Handle all received messages
+        for (std::size_t n = 0; n < received; ++n) {
+            // Longer messages are already rejected when receiving, shorter messages cannot be CHIRP messages
+            if (raw_msgs[n].length < CHIRP_V2_HEADER_LENGTH) {
+                continue;
+            }
+            HandleBroadcast(raw_msgs[n]);
+        }
+
+        // Publish changes once per batch instead of copying the discovered services for every change
+        if (discovered_services_snapshot_.load(std::memory_order_acquire)->generation !=
+            discovered_services_generation_.load(std::memory_order_acquire)) {
+            const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+            PublishDiscoveredServices();
+        }
+
+        // Notify callbacks and streams once the changes of the batch are published
+        DispatchNotifications();
+    });
+
+    // Interrupt receiving immediately when stop is requested
+    const std::stop_callback stop_callback {stop_token, [&receiver]() { receiver.Stop(); }};
+
+    // Block until stopped without polling
+    receiver.Run();
+}
+
+void Manager::HandleBroadcast(const BroadcastBuffer& raw_msg) {
+    const auto handle_time = std::chrono::steady_clock::now();
+    const std::span<const std::uint8_t> bytes = raw_msg.buffer.first(raw_msg.length);
+
+    // CHIRP v1 messages have a fixed length, which never matches the length of a CHIRP v2 message
+    if (bytes.size() == CHIRP_MESSAGE_LENGTH) {
+        // Decode in place, only the host ID is copied for discovered services
+        const MessageView chirp_msg {bytes.first<CHIRP_MESSAGE_LENGTH>()};
+        if (!chirp_msg.IsValid() || !AcceptBroadcast(chirp_msg.GetGroupID(), chirp_msg.GetHostID(), raw_msg)) {
+            return;
+        }
+
+        DiscoveredService discovered_service {raw_msg.address, MD5Hash(chirp_msg.GetHostID()), chirp_msg.GetServiceIdentifier(), chirp_msg.GetPort(), raw_msg.interface_index};
+
+        if (chirp_msg.GetType() == REQUEST) {
+            // Port of REQUESTs announces highest supported CHIRP version, CHIRP v1 hosts send arbitrary ports
+            const auto version = discovered_service.port == CHIRP_VERSION_2 ? CHIRP_VERSION_2 : CHIRP_VERSION;
+            {
+                const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+                UpdatePeerVersion(discovered_service.host_id, version, true);
+            }
+            HandleRequest(discovered_service.identifier, version);
+        }
+        else {
+            HandleService(chirp_msg.GetType(), discovered_service, handle_time, CHIRP_VERSION);
+        }
+        return;
+    }
+
+    const MultiMessageView chirp_msg {bytes};
+    if (!chirp_msg.IsValid() || !AcceptBroadcast(chirp_msg.GetGroupID(), chirp_msg.GetHostID(), raw_msg)) {
+        return;
+    }
+
+    DiscoveredService discovered_service {raw_msg.address, MD5Hash(chirp_msg.GetHostID()), CONTROL, 0, raw_msg.interface_index};
+    if (chirp_msg.GetType() == REQUEST) {
+        // Services of OFFERs and DEPARTs record the version together with the service
+        const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+        UpdatePeerVersion(discovered_service.host_id, CHIRP_VERSION_2, true);
+    }
+
+    for (std::size_t n = 0; n < chirp_msg.GetServiceCount(); ++n) {
+        discovered_service.identifier = chirp_msg.GetServiceIdentifier(n);
+        discovered_service.port = chirp_msg.GetPort(n);
+        if (chirp_msg.GetType() == REQUEST) {
+            HandleRequest(discovered_service.identifier, CHIRP_VERSION_2);
+        }
+        else {
+            HandleService(chirp_msg.GetType(), discovered_service, handle_time, CHIRP_VERSION_2);
+        }
+    }
+}
+
+bool Manager::AcceptBroadcast(std::span<const std::uint8_t, 16> group_id, std::span<const std::uint8_t, 16> host_id, const BroadcastBuffer& raw_msg) {
+    if (!std::ranges::equal(group_id, group_id_)) {
+        // Broadcast from different group, ignore
+        return false;
+    }
+    if (std::ranges::equal(host_id, host_id_)) {
+        // Broadcast from self, ignore
+        return false;
+    }
+
+    // Ignore broadcasts arriving on other interfaces
+    if (!interface_indices_.empty() && std::ranges::find(interface_indices_, raw_msg.interface_index) == interface_indices_.end()) {
+        return false;
+    }
+
+    // Record time the broadcast was queued since kernel received it
+    if (raw_msg.timestamp.has_value()) {
+        latency_recorder_->queue.Record(std::chrono::system_clock::now() - raw_msg.timestamp.value());
+    }
+    return true;
+}
+
+void Manager::HandleService(MessageType type,
+                            const DiscoveredService& discovered_service,
+                            std::chrono::steady_clock::time_point handle_time,
+                            std::uint8_t version) {
+    const bool depart = type == DEPART;
+
+    const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+    // Record version under the same lock as the service such that expiry cannot prune the host in between
+    UpdatePeerVersion(discovered_service.host_id, version, version == CHIRP_VERSION_2);
+
+    // OFFERs are only reported for new services, DEPARTs only for known services
+    bool changed = false;
+    if (depart) {
+        changed = discovered_services_.Erase(discovered_service);
+    }
+    else if (service_ttl_ > std::chrono::steady_clock::duration::zero()) {
+        // OFFERs for known services refresh their expiry
+        changed = discovered_services_.Refresh(discovered_service, GetExpiryTick(handle_time + service_ttl_) + 1);
+        ScheduleExpiry();
+    }
+    else {
+        changed = discovered_services_.Insert(discovered_service);
+    }
+    if (!changed) {
+        return;
+    }
+    discovered_services_generation_.store(discovered_services_.GetGeneration(), std::memory_order_release);
+    QueueNotification(discovered_service, depart, handle_time);
+    if (depart) {
+        PrunePeerVersion(discovered_service.host_id);
+    }
+}
+
+void Manager::QueueNotification(const DiscoveredService& discovered_service, bool depart, std::chrono::steady_clock::time_point handle_time) {
+    const std::lock_guard pending_notifications_lock {pending_notifications_mutex_};
+    pending_notifications_.push_back({discovered_service, depart, handle_time});
+}
+
+void Manager::DispatchNotifications() {
+    // Only one thread notifies at a time such that callbacks and streams receive notifications in the order of the
+    // changes, even if the queue of a callback thread is full and other threads handle further changes in the meantime
+    while (true) {
+        bool dispatching = false;
+        if (!dispatching_.compare_exchange_strong(dispatching, true)) {
+            // Notifications are left to the thread currently notifying
+            return;
+        }
+        while (true) {
+            {
+                const std::lock_guard pending_notifications_lock {pending_notifications_mutex_};
+                if (pending_notifications_.empty()) {
+                    break;
+                }
+                std::swap(pending_notifications_, dispatched_notifications_);
+            }
+            // Changes are queued after updating the generation, publish them such that callbacks and streams can read
+            // their service from the snapshot
+            if (discovered_services_snapshot_.load(std::memory_order_acquire)->generation !=
+                discovered_services_generation_.load(std::memory_order_acquire)) {
+                const std::lock_guard discovered_services_lock {discovered_services_mutex_};
+                PublishDiscoveredServices();
+            }
+            for (const auto& notification : dispatched_notifications_) {
+                NotifyService(notification.service, notification.depart, notification.handle_time);
+            }
+            dispatched_notifications_.clear();
+        }
+        dispatching_.store(false);
+
+        // Take over notifications queued by other threads after draining but before dispatching_ was reset
+        const std::lock_guard pending_notifications_lock {pending_notifications_mutex_};
+        if (pending_notifications_.empty()) {
+            return;
+        }
+    }
+}
+
+void Manager::NotifyService(const DiscoveredService& discovered_service, bool depart, std::chrono::steady_clock::time_point handle_time) {
+    std::vector<DiscoverCallbackEntry> callbacks {};
+    std::shared_ptr<CallbackPool> callback_pool {};
+    {
+        // Acquire shared lock for discover_callbacks_
+        const std::shared_lock discover_callbacks_lock {discover_callbacks_mutex_};
+        // Copy matching callbacks, they are queued after unlocking since a full queue only drains once its callbacks
+        // return, which might register or unregister callbacks
+        for (const auto& cb_entry : discover_callbacks_) {
+            if (cb_entry.service_id == discovered_service.identifier) {
+                callbacks.push_back(cb_entry);
+            }
+        }
+        callback_pool = callback_pool_;
+        // Queue events for subscribed streams
+        for (const auto& weak_stream : discover_streams_) {
+            if (auto stream = weak_stream.lock()) {
+                stream->Push({discovered_service, depart});
+            }
+        }
+    }
+    // Queue callbacks to the callback threads
+    for (auto& cb_entry : callbacks) {
+        callback_pool->Push(cb_entry.callback, discovered_service, depart, cb_entry.user_data, handle_time);
+    }
+
+    // Collect events for batch callbacks, wake up batch thread if a batch starts collecting or is full
+    const std::lock_guard batch_callbacks_lock {batch_callbacks_mutex_};
+    bool reschedule = false;
+    for (auto& state : batch_callbacks_) {
+        if (state.service_id == discovered_service.identifier) {
+            if (state.events.empty()) {
+                state.handle_time = handle_time;
+                reschedule = true;
+            }
+            state.events.push_back({discovered_service, depart});
+            reschedule = reschedule || state.events.size() == state.max_events;
+        }
+    }
+    if (reschedule) {
+        ++batch_schedules_;
+        batch_cv_.notify_one();
+    }
+}
+
+void Manager::UpdatePeerVersion(const MD5Hash& host_id, std::uint8_t version, bool announced) {
+    if (!protocol_v2_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const auto [peer_it, inserted] = peer_versions_.try_emplace(host_id, version);
+    if (inserted) {
+        if (version < CHIRP_VERSION_2) {
+            ++v1_peers_;
+        }
+    }
+    else if (announced && peer_it->second != version) {
+        if (version < CHIRP_VERSION_2) {
+            ++v1_peers_;
+        }
+        else {
+            --v1_peers_;
+        }
+        peer_it->second = version;
+    }
+    else {
+        return;
+    }
+
+    UpdateSendV2();
+}
+
+void Manager::PrunePeerVersion(const MD5Hash& host_id) {
+    if (!protocol_v2_.load(std::memory_order_relaxed) || discovered_services_.CountServices(host_id) > 0) {
+        return;
+    }
+
+    const auto peer_it = peer_versions_.find(host_id);
+    if (peer_it == peer_versions_.end()) {
+        return;
+    }
+    if (peer_it->second < CHIRP_VERSION_2) {
+        --v1_peers_;
+    }
+    peer_versions_.erase(peer_it);
+
+    UpdateSendV2();
+}
+
+void Manager::UpdateSendV2() {
+    // Only pack services once other hosts were seen and all of them can decode CHIRP v2 messages
+    send_v2_.store(!peer_versions_.empty() && v1_peers_ == 0, std::memory_order_relaxed);
 }
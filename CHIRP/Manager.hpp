@@ -1,10 +1,26 @@
 #pragma once
 
 #include <any>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
 #include <set>
+#include <shared_mutex>
+#include <span>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "asio.hpp"
@@ -13,7 +29,9 @@
 #include "CHIRP/BroadcastRecv.hpp"
 #include "CHIRP/BroadcastSend.hpp"
 #include "CHIRP/Message.hpp"
+#include "CHIRP/NetworkInterface.hpp"
 #include "CHIRP/protocol_info.hpp"
+#include "CHIRP/TimingWheel.hpp"
 
 namespace cnstln {
 namespace CHIRP {
@@ -27,6 +45,8 @@ struct RegisteredService {
     Port port;
 
     CHIRP_API bool operator<(const RegisteredService& other) const;
+
+    bool operator==(const RegisteredService& other) const = default;
 };
 
 /** A service discovered by the :cpp:class:`Manager` */
@@ -43,7 +63,247 @@ struct DiscoveredService {
     /** Port of the discovered service */
     Port port;
 
+    /**
+     * Index of the network interface on which the service was discovered
+     *
+     * Only recorded by managers constructed from a list of network interfaces, zero otherwise.
+     */
+    unsigned int interface_index {0};
+
     CHIRP_API bool operator<(const DiscoveredService& other) const;
+
+    /** Check if two discovered services are the same service of the same host, ignoring address and interface */
+    CHIRP_API bool operator==(const DiscoveredService& other) const;
+};
+
+/** A change to the discovered services, recorded by the :cpp:class:`DiscoveredServiceTable` */
+struct DiscoveredServiceChange {
+    /** Generation of the discovered services after the change */
+    std::uint64_t generation;
+
+    /** Discovered or departed service */
+    DiscoveredService service;
+
+    /** False if the service was discovered, true if the service departed */
+    bool depart;
+};
+
+/** Changes to the discovered services since a given generation */
+struct DiscoveredServiceChanges {
+    /** Current generation of the discovered services, to be passed to the next request for changes */
+    std::uint64_t generation;
+
+    /**
+     * Whether the changes since the given generation were no longer available
+     *
+     * If true, the list of changes instead contains a discovery for every currently discovered service, and the state
+     * derived from previous changes has to be discarded.
+     */
+    bool reset;
+
+    /** Changes in order of their generation */
+    std::vector<DiscoveredServiceChange> changes;
+};
+
+/**
+ * Table of discovered services used by the :cpp:class:`Manager`
+ *
+ * Services are stored contiguously and indexed by an open-addressing hash table with linear probing, keyed by host ID,
+ * service identifier and port (see :cpp:func:`DiscoveredService::operator==`). Each slot of the hash table stores a
+ * fragment of the hash next to the index of the service, such that probing rarely touches the services themselves. In
+ * addition, the services are indexed by service identifier, such that listing the services with a given service
+ * identifier only visits matching services. Insertion, removal and lookup take constant time on average. The order of
+ * the services is unspecified.
+ *
+ * Every change to the table increments its generation and is recorded in a ring buffer, such that the changes since a
+ * given generation can be retrieved in time proportional to their number, as long as they were not overwritten.
+ *
+ * Services can expire at a given tick, which is tracked by a :cpp:class:`TimingWheel`, such that refreshing the expiry
+ * of a service takes constant time and expiring services does not scan the table. Expired services are removed and
+ * recorded as departed. This class is not thread-safe.
+ */
+class DiscoveredServiceTable {
+public:
+    /** Default number of changes kept in the ring buffer */
+    static constexpr std::size_t DEFAULT_CHANGE_CAPACITY = 1024;
+
+    /**
+     * Construct an empty table
+     *
+     * @param change_capacity Number of changes kept in the ring buffer
+     */
+    CHIRP_API explicit DiscoveredServiceTable(std::size_t change_capacity = DEFAULT_CHANGE_CAPACITY);
+
+    /**
+     * Insert a service into the table
+     *
+     * @param service Discovered service
+     * @retval true If the service was inserted
+     * @retval false If the service was already in the table
+     */
+    CHIRP_API bool Insert(const DiscoveredService& service);
+
+    /**
+     * Insert a service into the table if not yet in the table, and set the tick at which the service expires
+     *
+     * @param service Discovered service
+     * @param expiry Tick at which the service expires, see :cpp:func:`Expire`
+     * @retval true If the service was inserted
+     * @retval false If the service was already in the table
+     */
+    CHIRP_API bool Refresh(const DiscoveredService& service, std::uint64_t expiry);
+
+    /**
+     * Remove all services which expired up to a given tick
+     *
+     * @param tick Current tick, has to increase monotonically
+     * @param expired Vector to which removed services are appended
+     */
+    CHIRP_API void Expire(std::uint64_t tick, std::vector<DiscoveredService>& expired);
+
+    /**
+     * Return the next tick at which :cpp:func:`Expire` has to be called
+     *
+     * See :cpp:func:`TimingWheel::GetNextTick`.
+     *
+     * @return Next tick at which services might expire, no value if no service expires
+     */
+    std::optional<std::uint64_t> GetNextExpiryTick() const { return timers_.GetNextTick(); }
+
+    /** Remove the expiry of all services such that they no longer expire */
+    CHIRP_API void ClearExpiries();
+
+    /**
+     * Remove a service from the table
+     *
+     * @param service Discovered service
+     * @retval true If the service was removed
+     * @retval false If the service was not in the table
+     */
+    CHIRP_API bool Erase(const DiscoveredService& service);
+
+    /**
+     * Check if a service is in the table
+     *
+     * @param service Discovered service
+     */
+    CHIRP_API bool Contains(const DiscoveredService& service) const;
+
+    /**
+     * Remove all services from the table
+     *
+     * Clearing increments the generation but is not recorded as change, thus requesting changes from before it results in
+     * a reset.
+     */
+    CHIRP_API void Clear();
+
+    /** Return the generation of the table, i.e. the number of changes since construction */
+    std::uint64_t GetGeneration() const { return generation_; }
+
+    /**
+     * Return the changes since a given generation
+     *
+     * If the changes are no longer in the ring buffer, a reset listing all services is returned instead.
+     *
+     * @param generation Generation after which changes are returned
+     */
+    CHIRP_API DiscoveredServiceChanges GetChanges(std::uint64_t generation) const;
+
+    /** Return the number of services in the table */
+    std::size_t Size() const { return entries_.size(); }
+
+    /**
+     * Return the number of services of a given host in the table
+     *
+     * @param host_id Host ID of the host
+     */
+    CHIRP_API std::size_t CountServices(const MD5Hash& host_id) const;
+
+    /** Return all services in the table */
+    CHIRP_API std::vector<DiscoveredService> GetServices() const;
+
+    /**
+     * Return all services with a given service identifier
+     *
+     * @param service_id Service identifier of the returned services
+     */
+    CHIRP_API std::vector<DiscoveredService> GetServices(ServiceIdentifier service_id) const;
+
+private:
+    /**
+     * Find the slot of a service, or the empty slot at which it would be inserted
+     *
+     * @param service Discovered service
+     * @param hash Hash of the service
+     */
+    std::size_t FindSlot(const DiscoveredService& service, std::size_t hash) const;
+
+    /**
+     * Insert a service into the table if not yet in the table
+     *
+     * @param service Discovered service
+     * @return Index of the service in :cpp:member:`entries_` and whether it was inserted
+     */
+    std::pair<std::uint32_t, bool> Emplace(const DiscoveredService& service);
+
+    /** Double the number of slots and reinsert all services */
+    void Grow();
+
+    /**
+     * Increment the generation and record the change in the ring buffer
+     *
+     * @param service Discovered or departed service
+     * @param depart True if the service departed
+     */
+    void RecordChange(const DiscoveredService& service, bool depart);
+
+private:
+    /** Stored service */
+    struct Entry {
+        DiscoveredService service;
+
+        /** Hash of the service */
+        std::size_t hash;
+
+        /** Position of the service in its list in :cpp:member:`service_indices_` */
+        std::uint32_t service_position;
+
+        /** Timer at which the service expires, with the index of the service as value */
+        TimingWheel::TimerID timer {TimingWheel::NO_TIMER};
+    };
+
+    /** Slot of the hash table */
+    struct Slot {
+        /** Index of the service in :cpp:member:`entries_` plus one, zero if the slot is empty */
+        std::uint32_t entry;
+
+        /** Lower bits of the hash of the service */
+        std::uint32_t hash;
+    };
+
+    /** Stored services, contiguous such that listing them is a copy */
+    std::vector<Entry> entries_;
+
+    /** Slots of the hash table, the number of slots is a power of two */
+    std::vector<Slot> slots_;
+
+    /** Indices of the services in :cpp:member:`entries_` by service identifier */
+    std::array<std::vector<std::uint32_t>, 256> service_indices_;
+
+    /** Number of services by host ID, only contains hosts with services */
+    std::unordered_map<MD5Hash, std::uint32_t> host_services_;
+
+    /** Ring buffer of recent changes, the change to generation ``n`` is stored at ``(n - 1) % size`` */
+    std::vector<DiscoveredServiceChange> changes_;
+
+    /** Number of changes since construction */
+    std::uint64_t generation_ {0};
+
+    /** Generation after the last clear, changes before it are not available */
+    std::uint64_t clear_generation_ {0};
+
+    /** Timers of services which expire */
+    TimingWheel timers_;
 };
 
 /**
@@ -54,8 +314,13 @@ struct DiscoveredService {
  * data passed to the callback (done via :cpp:func:`Manager::RegisterDiscoverCallback`).
  *
  * It is recommended to pass the user data wrapped in an atomic :cpp:class:`std::shared_ptr` since the callback is launched
- * asynchronously in a detached :cpp:class:`std::thread`. If the data is modified, it is recommended to use atomic types
- * when possible or a :cpp:class:`std::mutex` for locking to ensure thread-safe access.
+ * asynchronously on one of the callback threads of the manager (see :cpp:func:`Manager::SetCallbackThreads`). If the data
+ * is modified, it is recommended to use atomic types when possible or a :cpp:class:`std::mutex` for locking to ensure
+ * thread-safe access.
+ *
+ * Callbacks for the same service run in the order in which the service was discovered, departed or expired, even if
+ * these were handled by different background threads, while callbacks for different services may run concurrently. Since
+ * callbacks share a fixed number of threads, a callback should not block for long and must never wait for another callback.
  */
 using DiscoverCallback = void(DiscoveredService service, bool depart, std::any user_data);
 
@@ -77,6 +342,159 @@ struct DiscoverCallbackEntry {
     CHIRP_API bool operator<(const DiscoverCallbackEntry& other) const;
 };
 
+/** Newly discovered or departing service reported by a :cpp:class:`DiscoverEventStream` */
+struct DiscoverEvent {
+    /** Discovered or departing service */
+    DiscoveredService service;
+
+    /** False if the service is newly discovered, true if the service is departing */
+    bool depart;
+};
+
+/**
+ * Function signature for user batch callback
+ *
+ * The first argument (``events``) contains the discovery events collected since the last call in the order in which they
+ * were handled, and the second argument (``user_data``) is arbitrary user data passed to the callback (done via
+ * :cpp:func:`Manager::RegisterDiscoverBatchCallback`). The events are only valid during the call.
+ *
+ * Batch callbacks run on the callback threads of the manager like :cpp:type:`DiscoverCallback`, consecutive batches for the
+ * same callback run in order.
+ */
+using DiscoverBatchCallback = void(std::span<const DiscoverEvent> events, std::any user_data);
+
+/**
+ * Stream of discovery events from a :cpp:class:`Manager` that can be awaited from coroutines
+ *
+ * Created via :cpp:func:`Manager::SubscribeDiscoverEvents`. Events are queued by the manager and awaited one by one via
+ * :cpp:func:`Next`. Each pending wait only costs a coroutine frame instead of a thread. The stream is unsubscribed once
+ * it is destroyed.
+ */
+class DiscoverEventStream : public std::enable_shared_from_this<DiscoverEventStream> {
+public:
+    /**
+     * Construct discovery event stream, use :cpp:func:`Manager::SubscribeDiscoverEvents` instead
+     *
+     * @param executor Executor on which discovery events are awaited
+     */
+    CHIRP_API DiscoverEventStream(asio::any_io_executor executor);
+
+    /**
+     * Wait for the next discovery event (awaitable)
+     *
+     * Has to be awaited from a coroutine running on the executor of the stream. The executor must not run handlers
+     * concurrently, e.g. a single-threaded IO context or a strand.
+     *
+     * @return Awaitable resolving to the next discovery event, or to no event if the stream is closed
+     */
+    CHIRP_API asio::awaitable<std::optional<DiscoverEvent>> Next();
+
+    /**
+     * Close the stream
+     *
+     * Already queued discovery events can still be received. This function is thread-safe.
+     */
+    CHIRP_API void Close();
+
+private:
+    friend class Manager;
+
+    /**
+     * Queue a discovery event and wake up the awaiting coroutine
+     *
+     * This function is thread-safe.
+     *
+     * @param event Discovery event to queue
+     */
+    void Push(DiscoverEvent event);
+
+    /** Wake up the awaiting coroutine from any thread */
+    void Notify();
+
+private:
+    /** Timer used as signal, expires when events are queued or the stream is closed */
+    asio::steady_timer signal_;
+
+    /** Queued discovery events */
+    std::deque<DiscoverEvent> events_;
+
+    /** If the stream is closed */
+    bool closed_ {false};
+
+    /** Mutex for thread-safe access to :cpp:member:`events_` and :cpp:member:`closed_` */
+    std::mutex events_mutex_;
+};
+
+/** Statistics of a delay recorded by the :cpp:class:`Manager` */
+struct LatencyStats {
+    /** Number of recorded delays */
+    std::uint64_t count;
+
+    /** Sum of all recorded delays */
+    std::chrono::nanoseconds total;
+
+    /** Maximum recorded delay */
+    std::chrono::nanoseconds max;
+
+    /** Mean of all recorded delays */
+    constexpr std::chrono::nanoseconds mean() const { return count > 0 ? total / static_cast<std::int64_t>(count) : std::chrono::nanoseconds(0); }
+};
+
+/** Delays in the handling of incoming CHIRP broadcasts recorded by the :cpp:class:`Manager` */
+struct DiscoverLatencyStats {
+    /**
+     * Delay between the kernel receiving a CHIRP broadcast and the manager handling it
+     *
+     * Only recorded if kernel receive timestamps are enabled via :cpp:func:`Manager::EnableTimestamps`.
+     */
+    LatencyStats queue;
+
+    /** Delay between the manager handling a CHIRP broadcast and the start of the corresponding discovery callback */
+    LatencyStats dispatch;
+};
+
+/** Statistics of the replies of a :cpp:class:`Manager` to incoming REQUEST broadcasts */
+struct ReplyStats {
+    /** Number of incoming REQUEST broadcasts */
+    std::uint64_t requests;
+
+    /** Number of reply rounds in which OFFERs for all matching registered services were broadcast */
+    std::uint64_t replies;
+
+    /** Number of REQUEST broadcasts folded into an already scheduled reply round */
+    std::uint64_t coalesced;
+
+    /** Number of REQUEST broadcasts not answered since a reply round was broadcast shortly before */
+    std::uint64_t suppressed;
+};
+
+/** Statistics of the outgoing CHIRP broadcasts of a :cpp:class:`Manager` */
+struct SendStats {
+    /** Number of broadcasts queued for sending */
+    std::uint64_t queued;
+
+    /** Number of broadcasts sent on at least one interface */
+    std::uint64_t sent;
+
+    /** Number of broadcasts dropped since the sockets of all interfaces reported an error */
+    std::uint64_t failed;
+
+    /** Number of OFFERs and REQUESTs dropped since the send queue was full, these are not counted as queued */
+    std::uint64_t dropped;
+};
+
+/** Thread-safe recorder for :cpp:struct:`DiscoverLatencyStats` */
+struct LatencyRecorder;
+
+/** Lock-free queue of outgoing CHIRP broadcasts */
+struct SendQueue;
+
+/** Threads running discovery callbacks */
+struct CallbackPool;
+
+/** Immutable snapshot of the discovered services of a :cpp:class:`Manager` */
+struct DiscoveredServicesSnapshot;
+
 /** Manager for CHIRP broadcasting and receiving */
 class Manager {
 public:
@@ -96,6 +514,50 @@ public:
      */
     CHIRP_API Manager(std::string_view brd_ip, std::string_view any_ip, std::string_view group_name, std::string_view host_name);
 
+    /**
+     * Construct manager using multicast instead of broadcast
+     *
+     * Outgoing messages are sent to the multicast group and incoming messages are received on the any address of the
+     * same IP version after joining the multicast group. This is equivalent to passing the multicast address as
+     * ``brd_address``. For IPv6 link-local groups, the interface is given by the scope ID (e.g. ``ff02::7123%eth0``).
+     *
+     * @param multicast_address Multicast address for outgoing and incoming messages
+     * @param group_name Group name of the group to join
+     * @param host_name Host name for outgoing messages
+     */
+    CHIRP_API Manager(const asio::ip::address& multicast_address, std::string_view group_name, std::string_view host_name);
+
+    /**
+     * @param multicast_ip Multicast IP for outgoing and incoming messages
+     * @param group_name Group name of the group to join
+     * @param host_name Host name for outgoing messages
+     */
+    CHIRP_API Manager(std::string_view multicast_ip, std::string_view group_name, std::string_view host_name);
+
+    /**
+     * Construct manager sending and receiving on multiple network interfaces
+     *
+     * Outgoing messages are broadcast on each interface via its broadcast address. Incoming messages are received by a
+     * single socket on the IPv4 any address, and only broadcasts arriving on one of the interfaces are handled. All
+     * interfaces share one table of discovered services, in which each service records the interface it was discovered
+     * on. With an empty list of interfaces, this is equivalent to broadcasting to ``255.255.255.255``.
+     *
+     * @param interfaces Network interfaces to send and receive broadcasts on
+     * @param group_name Group name of the group to join
+     * @param host_name Host name for outgoing messages
+     */
+    CHIRP_API Manager(std::span<const NetworkInterface> interfaces, std::string_view group_name, std::string_view host_name);
+
+    /**
+     * Construct manager sending and receiving on all network interfaces supporting broadcasts
+     *
+     * The interfaces are enumerated once via :cpp:func:`GetNetworkInterfaces`.
+     *
+     * @param group_name Group name of the group to join
+     * @param host_name Host name for outgoing messages
+     */
+    CHIRP_API Manager(std::string_view group_name, std::string_view host_name);
+
     CHIRP_API virtual ~Manager();
 
     /**
@@ -112,8 +574,154 @@ public:
      */
     constexpr MD5Hash GetHostID() const { return host_id_; }
 
-    /** Start the background thread of the manager */
-    CHIRP_API void Start();
+    /**
+     * Start the background threads of the manager
+     *
+     * With more than one receive thread, the manager opens one ``SO_REUSEPORT`` socket per thread and spreads incoming
+     * broadcasts over them by host ID (see :cpp:func:`BroadcastRecv::SetShard`), such that all broadcasts from one host
+     * are handled by the same thread in order. If this is not supported on the platform, a single thread is used.
+     * Receive settings and statistics may be accessed from other threads while the receivers are replaced.
+     *
+     * @param recv_threads Number of threads receiving and handling incoming broadcasts
+     */
+    CHIRP_API void Start(std::size_t recv_threads = 1);
+
+    /**
+     * Enable kernel-level filtering of incoming broadcasts
+     *
+     * Attaches a socket filter to the receiver which only accepts CHIRP broadcasts of this group, see
+     * :cpp:func:`BroadcastRecv::AttachFilter`. Other broadcasts on :cpp:var:`CHIRP_PORT` are then dropped by the kernel
+     * and never wake up the background thread. This is optional since incoming broadcasts are filtered by the manager
+     * anyway. Unless :cpp:func:`EnableProtocolV2` is called, the filter only accepts CHIRP v1 messages.
+     *
+     * @retval true If the filter was attached
+     * @retval false If kernel-level filtering is not supported on this platform
+     */
+    CHIRP_API bool EnableKernelFilter();
+
+    /**
+     * Set size of the socket receive buffers of all receivers
+     *
+     * Larger buffers allow to absorb bursts of incoming broadcasts, see :cpp:func:`BroadcastRecv::SetReceiveBufferSize`.
+     * The size is also applied to receivers opened later by :cpp:func:`Start`.
+     *
+     * @param size Requested size of the socket receive buffers in bytes
+     */
+    CHIRP_API void SetReceiveBufferSize(std::size_t size);
+
+    /**
+     * Set size of the socket send buffer, see :cpp:func:`BroadcastSend::SetSendBufferSize`
+     *
+     * @param size Requested size of the socket send buffer in bytes
+     */
+    CHIRP_API void SetSendBufferSize(std::size_t size);
+
+    /**
+     * Get receive statistics summed over all receivers
+     *
+     * This can be used to detect if incoming broadcasts are lost due to full socket receive buffers, see
+     * :cpp:struct:`BroadcastRecvStats`.
+     *
+     * @return Receive statistics of the manager
+     */
+    CHIRP_API BroadcastRecvStats GetRecvStats();
+
+    /**
+     * Receive incoming and send outgoing broadcasts via io_uring
+     *
+     * See :cpp:func:`BroadcastRecv::EnableIoUring` and :cpp:func:`BroadcastSend::EnableIoUring`. Running background
+     * threads are restarted. Also applied to receivers opened later by :cpp:func:`Start`.
+     *
+     * @retval true If io_uring is used for receiving incoming and sending outgoing broadcasts
+     * @retval false If io_uring is not supported
+     */
+    CHIRP_API bool EnableIoUring();
+
+    /**
+     * Enable kernel receive timestamps for incoming broadcasts
+     *
+     * If enabled, the manager records the delay between the kernel receiving a CHIRP broadcast and the manager handling
+     * it (see :cpp:func:`GetLatencyStats`). Only supported on Linux.
+     *
+     * @retval true If kernel receive timestamps were enabled
+     * @retval false If kernel receive timestamps are not supported on this platform
+     */
+    CHIRP_API bool EnableTimestamps();
+
+    /**
+     * Get statistics of the delays in the handling of incoming CHIRP broadcasts
+     *
+     * @return Queueing and dispatch delay statistics since construction or the last reset
+     */
+    CHIRP_API DiscoverLatencyStats GetLatencyStats();
+
+    /** Reset the statistics of the delays in the handling of incoming CHIRP broadcasts */
+    CHIRP_API void ResetLatencyStats();
+
+    /**
+     * Set the maximum random delay of replies to incoming REQUEST broadcasts
+     *
+     * When many hosts start at the same time, every host answers the REQUEST of every other host, such that the number of
+     * broadcasts grows quadratically with the number of hosts. With a jitter, replies are broadcast by a background
+     * thread after a random delay between zero and the jitter. Further REQUESTs for the same service identifier arriving
+     * in the meantime are answered by the same reply round. By default, replies are broadcast immediately.
+     *
+     * @param jitter Maximum delay of replies to incoming REQUEST broadcasts
+     */
+    CHIRP_API void SetReplyJitter(std::chrono::steady_clock::duration jitter);
+
+    /**
+     * Set the time after a reply round during which incoming REQUEST broadcasts are not answered
+     *
+     * REQUESTs for a service identifier arriving shortly after OFFERs for all matching registered services were broadcast
+     * are already answered by these OFFERs. The hold-off should be small compared to the time hosts need to start
+     * receiving, since a host starting within the hold-off would otherwise miss the OFFERs. Disabled by default.
+     *
+     * @param hold_off Time after a reply round during which incoming REQUEST broadcasts are ignored
+     */
+    CHIRP_API void SetReplyHoldOff(std::chrono::steady_clock::duration hold_off);
+
+    /**
+     * Enable CHIRP v2 messages with multiple services per broadcast
+     *
+     * Outgoing REQUESTs announce support for CHIRP v2 in their otherwise unused port field. REQUESTs announcing support
+     * are answered by offering all services of the host packed into :cpp:class:`MultiMessage` broadcasts, such that
+     * REQUESTs for different service identifiers are answered by a single reply round. Once every other host seen by the
+     * manager announced support, the OFFERs and DEPARTs of :cpp:func:`RegisterServices` and
+     * :cpp:func:`UnregisterServices` are packed as well. As soon as a host only supporting CHIRP v1 is seen, these fall
+     * back to CHIRP v1 messages until the last discovered service of that host departs or expires. Incoming CHIRP v2
+     * messages are decoded regardless of this setting, but only pass the filter of :cpp:func:`EnableKernelFilter` once
+     * CHIRP v2 is enabled.
+     */
+    CHIRP_API void EnableProtocolV2();
+
+    /**
+     * Check if OFFERs and DEPARTs of registered services are packed into CHIRP v2 messages
+     *
+     * See :cpp:func:`EnableProtocolV2`.
+     *
+     * @return If CHIRP v2 is enabled and all other hosts seen by the manager support CHIRP v2
+     */
+    CHIRP_API bool UsesProtocolV2() const;
+
+    /**
+     * Get statistics of the outgoing CHIRP broadcasts
+     *
+     * Broadcasts are queued by the calling thread and sent by a background thread, such that registering services or
+     * sending requests never blocks on the socket. Errors reported by the socket are counted instead of thrown. OFFERs and
+     * REQUESTs are dropped and counted if the send queue is full, which holds 1024 broadcasts. DEPARTs are never dropped,
+     * they are kept until the queue is drained such that other hosts do not keep departed services.
+     *
+     * @return Send statistics since construction
+     */
+    CHIRP_API SendStats GetSendStats();
+
+    /**
+     * Get statistics of the replies to incoming REQUEST broadcasts
+     *
+     * @return Reply statistics since construction
+     */
+    CHIRP_API ReplyStats GetReplyStats();
 
     /**
      * Register a service offered by the host in the manager
@@ -141,10 +749,34 @@ public:
      */
     CHIRP_API bool UnregisterService(ServiceIdentifier service_id, Port port);
 
+    /**
+     * Register multiple services offered by the host in the manager
+     *
+     * Equivalent to calling :cpp:func:`RegisterService` for every service, but the CHIRP broadcasts with OFFER type for
+     * all newly registered services are sent in a batch, or packed into CHIRP v2 messages if negotiated (see
+     * :cpp:func:`EnableProtocolV2`).
+     *
+     * @param services Services offered by the host
+     * @return Number of services that were registered and not already registered before
+     */
+    CHIRP_API std::size_t RegisterServices(std::span<const RegisteredService> services);
+
+    /**
+     * Unregister multiple previously registered services offered by the host in the manager
+     *
+     * Equivalent to calling :cpp:func:`UnregisterService` for every service, but the CHIRP broadcasts with DEPART type
+     * for all unregistered services are sent in a batch, or packed into CHIRP v2 messages if negotiated.
+     *
+     * @param services Services previously offered by the host
+     * @return Number of services that were unregistered
+     */
+    CHIRP_API std::size_t UnregisterServices(std::span<const RegisteredService> services);
+
     /**
      * Unregisteres all offered services registered in the manager
      *
-     * Equivalent to calling :cpp:func:`UnregisterService` for every registered service.
+     * Equivalent to calling :cpp:func:`UnregisterService` for every registered service, but the CHIRP broadcasts with
+     * DEPART type are sent in a batch, or packed into CHIRP v2 messages if negotiated.
      */
     CHIRP_API void UnregisterServices();
 
@@ -155,6 +787,17 @@ public:
      */
     CHIRP_API std::set<RegisteredService> GetRegisteredServices();
 
+    /**
+     * Set the number of threads running discovery callbacks
+     *
+     * Callbacks are queued to a fixed number of threads, four by default, which are started when the first callback is
+     * registered. Callbacks for the same service are always run by the same thread. Callbacks already queued are run
+     * before the previous threads are stopped, thus this function must not be called from within a callback.
+     *
+     * @param threads Number of callback threads, at least one
+     */
+    CHIRP_API void SetCallbackThreads(std::size_t threads);
+
     /**
      * Register a user callback for newly discovered or departing servies
      *
@@ -178,23 +821,122 @@ public:
      */
     CHIRP_API bool UnregisterDiscoverCallback(DiscoverCallback* callback, ServiceIdentifier service_id);
 
+    /**
+     * Register a user batch callback for newly discovered or departing services
+     *
+     * Instead of calling the callback for every discovered or departing service, discovery events are collected and
+     * passed to the callback together. A batch is delivered once its first event was handled longer than the time window
+     * ago or once it contains the maximum number of events. This allows for example to rebuild a connection table once
+     * for many services discovered at startup.
+     *
+     * @param callback Function pointer to a batch callback
+     * @param service_id Service identifier of the services for which events should be received
+     * @param user_data Arbitrary user data passed to the callback function (see :cpp:type:`DiscoverBatchCallback`)
+     * @param window Time window over which events are collected
+     * @param max_events Maximum number of events per batch, at least one
+     * @retval true If the callback/service combination was registered
+     * @retval false If the callback/service combination was already registered
+     */
+    CHIRP_API bool RegisterDiscoverBatchCallback(DiscoverBatchCallback* callback,
+                                                 ServiceIdentifier service_id,
+                                                 std::any user_data,
+                                                 std::chrono::steady_clock::duration window,
+                                                 std::size_t max_events);
+
+    /**
+     * Unregister a previously registered batch callback
+     *
+     * Events collected but not yet delivered to the callback are discarded.
+     *
+     * @param callback Function pointer to the batch callback
+     * @param service_id Service identifier of the registered batch callback
+     * @retval true If the batch callback was unregistered
+     * @retval false If the batch callback was never registered
+     */
+    CHIRP_API bool UnregisterDiscoverBatchCallback(DiscoverBatchCallback* callback, ServiceIdentifier service_id);
+
     /**
      * Unregisteres all discovery callbacks registered in the manager
      *
-     * Equivalent to calling :cpp:func:`UnregisterDiscoverCallback` for every discovery callback.
+     * Equivalent to calling :cpp:func:`UnregisterDiscoverCallback` for every discovery callback and
+     * :cpp:func:`UnregisterDiscoverBatchCallback` for every batch callback.
      */
     CHIRP_API void UnregisterDiscoverCallbacks();
 
-    /** Forgets all previously discovered services */
+    /**
+     * Subscribe to a stream of newly discovered or departing services
+     *
+     * Alternative to discovery callbacks for applications using coroutines. The returned stream receives discovery
+     * events of all services until it is destroyed or the manager is destructed, after which the stream is closed.
+     *
+     * @param executor Executor on which discovery events are awaited (see :cpp:func:`DiscoverEventStream::Next`)
+     * @return Subscribed discovery event stream
+     */
+    CHIRP_API std::shared_ptr<DiscoverEventStream> SubscribeDiscoverEvents(asio::any_io_executor executor);
+
+    /** Forgets all previously discovered services and the CHIRP versions supported by other hosts */
     CHIRP_API void ForgetDiscoveredServices();
 
+    /**
+     * Set the time to live of discovered services
+     *
+     * Discovered services which are not refreshed by an OFFER within their time to live expire, e.g. when a host stopped
+     * without sending DEPARTs. Expired services are removed and reported as departing to callbacks and streams. Hosts
+     * offering their services have to send OFFERs more often than the time to live, e.g. by answering periodic
+     * REQUESTs. Setting the time to live refreshes all discovered services. Disabled by default.
+     *
+     * @param ttl Time to live of discovered services, zero to disable expiry
+     */
+    CHIRP_API void SetServiceTTL(std::chrono::steady_clock::duration ttl);
+
     /**
      * Returns list of all discovered services
      *
+     * The list is copied from the latest snapshot (see :cpp:func:`GetDiscoveredServicesSnapshot`) without locking, thus it
+     * might not yet contain changes from a batch of broadcasts which is still being handled. Callbacks and streams are
+     * only notified once the snapshot contains their change.
+     *
      * @returns Vector with all discovered services
      */
     CHIRP_API std::vector<DiscoveredService> GetDiscoveredServices();
 
+    /**
+     * Returns immutable snapshot of all discovered services
+     *
+     * Snapshots are published atomically by the background threads handling incoming broadcasts, once per batch of
+     * received broadcasts and whenever services expire or are forgotten. Reading them neither locks nor copies, thus
+     * frequent reads from many threads do not compete with the background threads. A snapshot stays valid while it is
+     * held, even if services are discovered or depart in the meantime. Changes from a batch of broadcasts which is still
+     * being handled are not yet contained, callbacks and streams are only notified once their change is published. This
+     * function is thread-safe.
+     *
+     * @returns Shared pointer to vector with all discovered services
+     */
+    CHIRP_API std::shared_ptr<const std::vector<DiscoveredService>> GetDiscoveredServicesSnapshot();
+
+    /**
+     * Returns the generation of the discovered services
+     *
+     * The generation increases with every discovered or departing service and when forgetting discovered services. This
+     * function is thread-safe and does not lock.
+     *
+     * @returns Generation of the discovered services
+     */
+    CHIRP_API std::uint64_t GetDiscoveredServicesGeneration() const;
+
+    /**
+     * Returns the changes to the discovered services since a given generation
+     *
+     * This allows to keep track of the discovered services by polling, at a cost proportional to the number of changes.
+     * Start with generation zero and pass the generation of the returned changes to the next call. If the changes are no
+     * longer available, e.g. because too many changes happened in between or the discovered services were forgotten, a
+     * reset listing all discovered services is returned instead (see :cpp:member:`DiscoveredServiceChanges::reset`).
+     *
+     * @param generation Generation after which changes are returned
+     * @returns Changes since the given generation
+     */
+    CHIRP_API DiscoveredServiceChanges GetDiscoveredServiceChanges(std::uint64_t generation);
+
     /**
      * Returns list of all discovered services with a given service identifier
      *
@@ -209,7 +951,7 @@ public:
      * This sends a CHIRP broadcast with a REQUEST type and a given service identifier. Other hosts might reply with a
      * CHIRP broadcast with OFFER type for the given service identifier. These can be retrieved either by registering a user
      * callback (see :cpp:func:`RegisterDiscoverCallback`) or by getting the list of discovered services shortly after
-     * (see :cpp:func:`GetDiscoveredServices`).
+     * (see :cpp:func:`GetDiscoveredServices`). The REQUEST is always a CHIRP v1 message.
      *
      * @param service_id Service identifier to send a request for
      */
@@ -217,51 +959,436 @@ public:
 
 private:
     /**
-     * Send a CHIRP broadcast
+     * Broadcast OFFERs for all registered services with a given service identifier
+     *
+     * @param service_id Service identifier for which to broadcast OFFERs
+     */
+    void SendOffers(ServiceIdentifier service_id);
+
+    /** Broadcast OFFERs for all registered services packed into CHIRP v2 messages */
+    void SendPackedOffers();
+
+    /**
+     * Answer an incoming REQUEST broadcast, either immediately or by scheduling a delayed reply round
+     *
+     * @param service_id Service identifier of the REQUEST
+     * @param version Highest CHIRP version supported by the requesting host
+     */
+    void HandleRequest(ServiceIdentifier service_id, std::uint8_t version);
+
+    /**
+     * Loop sending queued CHIRP broadcasts in batches until stopped and the queue is drained
+     *
+     * @param stop_token Token to stop loop
+     */
+    void SendLoop(const std::stop_token& stop_token);
+
+    /**
+     * Loop broadcasting scheduled reply rounds when they are due
+     *
+     * @param stop_token Token to stop loop
+     */
+    void ReplyLoop(const std::stop_token& stop_token);
+
+    /**
+     * Loop passing collected discovery events to batch callbacks when they are due, until stopped and all are passed
+     *
+     * @param stop_token Token to stop loop
+     */
+    void BatchLoop(const std::stop_token& stop_token);
+
+    /**
+     * Loop removing expired discovered services and notifying callbacks and streams
+     *
+     * @param stop_token Token to stop loop
+     */
+    void ExpiryLoop(const std::stop_token& stop_token);
+
+    /**
+     * Queue a CHIRP broadcast for sending
      *
      * @param type CHIRP broadcast message type
      * @param service Service with identifier and port
      */
     void SendMessage(MessageType type, RegisteredService service);
 
+    /**
+     * Queue CHIRP broadcasts for multiple services for sending
+     *
+     * @param type CHIRP broadcast message type
+     * @param services Services with identifier and port
+     */
+    void SendMessages(MessageType type, std::span<const RegisteredService> services);
+
+    /**
+     * Queue CHIRP v2 broadcasts packing multiple services for sending
+     *
+     * @param type CHIRP broadcast message type
+     * @param services Services with identifier and port
+     */
+    void SendPackedMessages(MessageType type, std::span<const RegisteredService> services);
+
+    /**
+     * Create receiver for incoming messages, joining the multicast group if set and applying the receiver settings,
+     * requires holding the receiver lock
+     *
+     * @param reuse_port If the receiver shares its port with other receivers
+     */
+    std::unique_ptr<BroadcastRecv> CreateReceiver(bool reuse_port = false);
+
+    /**
+     * Attach the kernel-level filter for CHIRP broadcasts of this group to a receiver
+     *
+     * @param receiver Receiver to which the filter is attached
+     * @return If the filter was attached
+     */
+    bool AttachKernelFilter(BroadcastRecv& receiver) const;
+
     /**
      * Run loop listening and responding to incoming CHIRP broadcasts
      *
      * The run loop responds to incoming CHIRP broadcasts with REQUEST type by sending CHIRP broadcasts with OFFER type for
      * all registered servies. It also tracks incoming CHIRP broadcasts with OFFER and DEPART type to form the list of
-     * discovered services and calls the corresponding discovery callbacks.
+     * discovered services and calls the corresponding discovery callbacks. The run loop waits for incoming broadcasts
+     * without polling and is interrupted immediately when a stop is requested.
      *
      * @param stop_token Token to stop loop via :cpp:class:`std::jthread`
+     * @param receiver Receiver from which incoming broadcasts are handled
+     */
+    void Run(std::stop_token stop_token, BroadcastRecv& receiver);
+
+    /**
+     * Handle an incoming CHIRP broadcast
+     *
+     * This function is called concurrently from all background threads.
+     *
+     * Both CHIRP v1 and CHIRP v2 messages are decoded, distinguished by their length.
+     *
+     * @param raw_msg Buffer into which the message was received
+     */
+    void HandleBroadcast(const BroadcastBuffer& raw_msg);
+
+    /**
+     * Check if an incoming CHIRP broadcast is from another host of the group and arrived on a handled interface
+     *
+     * @param group_id Group ID of the broadcast
+     * @param host_id Host ID of the broadcast
+     * @param raw_msg Buffer into which the message was received
+     */
+    bool AcceptBroadcast(std::span<const std::uint8_t, 16> group_id, std::span<const std::uint8_t, 16> host_id, const BroadcastBuffer& raw_msg);
+
+    /**
+     * Track a newly discovered or departing service and queue notifications for callbacks and streams, which are
+     * dispatched once per batch of received broadcasts
+     *
+     * @param type Either OFFER or DEPART
+     * @param service Discovered service
+     * @param handle_time Time at which the broadcast was handled
+     * @param version CHIRP version of the broadcast, CHIRP v2 broadcasts announce support for CHIRP v2
+     */
+    void HandleService(MessageType type,
+                       const DiscoveredService& service,
+                       std::chrono::steady_clock::time_point handle_time,
+                       std::uint8_t version);
+
+    /**
+     * Notify callbacks and streams of a newly discovered or departing service
+     *
+     * @param service Discovered service
+     * @param depart True if the service is departing
+     * @param handle_time Time at which the broadcast was handled or the service expired
+     */
+    void NotifyService(const DiscoveredService& service, bool depart, std::chrono::steady_clock::time_point handle_time);
+
+    /**
+     * Queue notification of a newly discovered or departing service, requires holding the discovered services lock such
+     * that notifications are queued in the order of the changes of the discovered services
+     *
+     * @param service Discovered service
+     * @param depart True if the service is departing
+     * @param handle_time Time at which the broadcast was handled or the service expired
      */
-    void Run(std::stop_token stop_token);
+    void QueueNotification(const DiscoveredService& service, bool depart, std::chrono::steady_clock::time_point handle_time);
+
+    /**
+     * Notify callbacks and streams of all queued notifications in order, called after releasing the discovered services
+     * lock. Changes not yet published are published before notifying. If another thread is already notifying, the
+     * notifications are left to that thread.
+     */
+    void DispatchNotifications();
+
+    /**
+     * Convert a time to a tick of the expiry of discovered services
+     *
+     * @param time Time after the construction of the manager
+     * @return Number of ticks since the construction of the manager
+     */
+    std::uint64_t GetExpiryTick(std::chrono::steady_clock::time_point time) const;
+
+    /**
+     * Publish a new snapshot of the discovered services if they changed since the latest snapshot, requires holding the
+     * discovered services lock
+     */
+    void PublishDiscoveredServices();
+
+    /** Wake up expiry thread if a service expires earlier than it waits for, requires holding the discovered services lock */
+    void ScheduleExpiry();
+
+    /**
+     * Record the highest CHIRP version supported by another host and update if CHIRP v2 messages are sent, requires
+     * holding the discovered services lock
+     *
+     * @param host_id Host ID of the other host
+     * @param version Highest CHIRP version supported by the other host
+     * @param announced If the version was announced by the host, otherwise it is only recorded for unknown hosts
+     */
+    void UpdatePeerVersion(const MD5Hash& host_id, std::uint8_t version, bool announced);
+
+    /**
+     * Forget the CHIRP version of another host if it has no discovered services left, requires holding the discovered
+     * services lock
+     *
+     * @param host_id Host ID of the other host whose service departed or expired
+     */
+    void PrunePeerVersion(const MD5Hash& host_id);
+
+    /** Update if CHIRP v2 messages are sent from the recorded peer versions, requires holding the discovered services lock */
+    void UpdateSendV2();
 
 private:
-    BroadcastRecv receiver_;
-    BroadcastSend sender_;
+    asio::ip::address any_address_;
+    std::optional<asio::ip::address> multicast_address_;
+
+    /** Receivers for incoming broadcasts, one per background thread */
+    std::vector<std::unique_ptr<BroadcastRecv>> receivers_;
+
+    /** Senders for outgoing broadcasts, one per network interface */
+    std::vector<std::unique_ptr<BroadcastSend>> senders_;
+
+    /** Indices of the network interfaces on which incoming broadcasts are handled, empty for all interfaces */
+    std::vector<unsigned int> interface_indices_;
+
+    /** Mutex for thread-safe access to :cpp:member:`senders_` */
+    std::mutex sender_mutex_;
+
+    /**
+     * Mutex for thread-safe access to :cpp:member:`receivers_` and their settings, replaced by :cpp:func:`Start` while
+     * settings and statistics are accessed by other threads
+     */
+    std::mutex receiver_mutex_;
+
+    /** Queue of outgoing broadcasts, drained by :cpp:member:`send_thread_` */
+    std::unique_ptr<SendQueue> send_queue_;
 
     MD5Hash group_id_;
     MD5Hash host_id_;
 
-    /** Set of registered services */
-    std::set<RegisteredService> registered_services_;
+    /** If kernel-level filtering is enabled for the receivers */
+    bool kernel_filter_ {false};
+
+    /** Requested size of the socket receive buffers, zero for the system default */
+    std::size_t receive_buffer_size_ {0};
+
+    /** If kernel receive timestamps are enabled for the receivers */
+    bool timestamps_ {false};
+
+    /** If the receivers use io_uring */
+    bool io_uring_ {false};
+
+    /** Recorder for delay statistics, shared with the callback threads */
+    std::shared_ptr<LatencyRecorder> latency_recorder_;
+
+    /** Registered services with their assembled OFFER */
+    std::map<RegisteredService, AssembledMessage> registered_services_;
 
     /** Mutex for thread-safe access to :cpp:member:`registered_services_` */
-    std::mutex registered_services_mutex_;
+    std::shared_mutex registered_services_mutex_;
 
-    /** Set of discovered services */
-    std::set<DiscoveredService> discovered_services_;
+    /** Table of discovered services */
+    DiscoveredServiceTable discovered_services_;
 
     /** Mutex for thread-safe access to :cpp:member:`discovered_services_` */
     std::mutex discovered_services_mutex_;
 
+    /** Generation of :cpp:member:`discovered_services_`, only updated while holding the mutex */
+    std::atomic_uint64_t discovered_services_generation_ {0};
+
+    /** Latest snapshot of :cpp:member:`discovered_services_`, only published while holding the mutex */
+    std::atomic<std::shared_ptr<const DiscoveredServicesSnapshot>> discovered_services_snapshot_;
+
+    /** Time to live of discovered services, zero if disabled, only accessed while holding the discovered services lock */
+    std::chrono::steady_clock::duration service_ttl_ {};
+
+    /** Time of tick zero of the expiry of discovered services */
+    std::chrono::steady_clock::time_point expiry_epoch_ {std::chrono::steady_clock::now()};
+
+    /** Tick until which the expiry thread waits, only accessed while holding the discovered services lock */
+    std::uint64_t expiry_wake_tick_ {std::numeric_limits<std::uint64_t>::max()};
+
+    /** Number of times the expiry thread was woken up early, used to wake up the expiry thread */
+    std::uint64_t expiry_schedules_ {0};
+
+    /** Condition variable to notify the expiry thread of a service expiring earlier */
+    std::condition_variable_any expiry_cv_;
+
+    /** Notification of a newly discovered or departing service */
+    struct PendingNotification {
+        DiscoveredService service;
+        bool depart;
+        std::chrono::steady_clock::time_point handle_time;
+    };
+
+    /** Notifications in the order of the changes of :cpp:member:`discovered_services_` */
+    std::vector<PendingNotification> pending_notifications_;
+
+    /** Mutex for thread-safe access to :cpp:member:`pending_notifications_` */
+    std::mutex pending_notifications_mutex_;
+
+    /** Notifications taken by the notifying thread, only accessed while :cpp:member:`dispatching_` is set by this thread */
+    std::vector<PendingNotification> dispatched_notifications_;
+
+    /** If a thread is notifying callbacks and streams of queued notifications */
+    std::atomic_bool dispatching_ {false};
+
     /** Set of discovery callbacks */
     std::set<DiscoverCallbackEntry> discover_callbacks_;
 
-    /** Mutex for thread-safe access to :cpp:member:`discover_callbacks_` */
-    std::mutex discover_callbacks_mutex_;
+    /** Subscribed discovery event streams, expired if unsubscribed */
+    std::vector<std::weak_ptr<DiscoverEventStream>> discover_streams_;
+
+    /**
+     * Threads running discovery callbacks, started when the first callback is registered, shared with threads queueing
+     * callbacks without holding :cpp:member:`discover_callbacks_mutex_`
+     */
+    std::shared_ptr<CallbackPool> callback_pool_;
+
+    /** Number of threads of :cpp:member:`callback_pool_` */
+    std::size_t callback_threads_;
+
+    /**
+     * Mutex for thread-safe access to :cpp:member:`discover_callbacks_`, :cpp:member:`discover_streams_` and
+     * :cpp:member:`callback_pool_`
+     */
+    std::shared_mutex discover_callbacks_mutex_;
+
+    /** Batch callback with its collected discovery events */
+    struct BatchCallbackState {
+        DiscoverBatchCallback* callback;
+        ServiceIdentifier service_id;
+        std::any user_data;
+        std::chrono::steady_clock::duration window;
+        std::size_t max_events;
+
+        /** Discovery events collected for the next batch */
+        std::vector<DiscoverEvent> events;
+
+        /** Time at which the first event of the next batch was handled */
+        std::chrono::steady_clock::time_point handle_time;
+    };
+
+    /** Registered batch callbacks */
+    std::vector<BatchCallbackState> batch_callbacks_;
+
+    /** Number of batches that became due early or started collecting, used to wake up the batch thread */
+    std::uint64_t batch_schedules_ {0};
+
+    /** Mutex for thread-safe access to :cpp:member:`batch_callbacks_` */
+    std::mutex batch_callbacks_mutex_;
 
-    std::jthread run_thread_;
+    /** Condition variable to notify the batch thread of a new or full batch */
+    std::condition_variable_any batch_cv_;
+
+    /** Reply state for one service identifier */
+    struct ReplyState {
+        /** If a reply round is scheduled */
+        bool pending {false};
+
+        /** Time at which the scheduled reply round is due */
+        std::chrono::steady_clock::time_point deadline;
+
+        /** Time at which the last reply round was broadcast */
+        std::chrono::steady_clock::time_point last_reply;
+    };
+
+    /** Reply states indexed by service identifier, index zero for reply rounds packed into CHIRP v2 messages */
+    std::array<ReplyState, 256> reply_states_ {};
+
+    /** Maximum random delay of replies */
+    std::chrono::steady_clock::duration reply_jitter_ {};
+
+    /** Time after a reply round during which REQUESTs are ignored */
+    std::chrono::steady_clock::duration reply_hold_off_ {};
+
+    /** Reply statistics */
+    ReplyStats reply_stats_ {};
+
+    /** Number of scheduled reply rounds, used to wake up the reply thread */
+    std::uint64_t reply_schedules_ {0};
+
+    /** Random generator for reply delays */
+    std::minstd_rand reply_random_ {std::random_device()()};
+
+    /** Mutex for thread-safe access to the reply state, statistics and random generator */
+    std::mutex reply_mutex_;
+
+    /** Condition variable to notify the reply thread of a scheduled reply round */
+    std::condition_variable_any reply_cv_;
+
+    /** If CHIRP v2 is enabled, see :cpp:func:`EnableProtocolV2` */
+    std::atomic_bool protocol_v2_ {false};
+
+    /** If CHIRP v2 was negotiated with all other hosts */
+    std::atomic_bool send_v2_ {false};
+
+    /**
+     * Highest CHIRP version supported by all other hosts seen since CHIRP v2 was enabled, by host ID
+     *
+     * Hosts are removed when their last discovered service departs or expires. Hosts that never offered a service, e.g.
+     * because they only sent REQUESTs, are kept until :cpp:func:`ForgetDiscoveredServices` is called, since their
+     * departure is never announced. Guarded by :cpp:member:`discovered_services_mutex_` such that the versions are
+     * updated consistently with the discovered services of the host.
+     */
+    std::unordered_map<MD5Hash, std::uint8_t> peer_versions_;
+
+    /** Number of hosts in :cpp:member:`peer_versions_` only supporting CHIRP v1 */
+    std::size_t v1_peers_ {0};
+
+    /** Background threads, one per receiver */
+    std::vector<std::jthread> run_threads_;
+
+    /** Background thread broadcasting delayed replies, started when a reply jitter is set */
+    std::jthread reply_thread_;
+
+    /** Background thread sending queued broadcasts */
+    std::jthread send_thread_;
+
+    /** Background thread passing due batches to the callback threads, started with the first batch callback */
+    std::jthread batch_thread_;
+
+    /** Background thread expiring discovered services, started when a time to live is set */
+    std::jthread expiry_thread_;
 };
 
 } // namespace CHIRP
 } // namespace cnstln
+
+namespace std {
+
+/** Hash of a registered service, consistent with :cpp:func:`RegisteredService::operator==` */
+template <>
+struct hash<cnstln::CHIRP::RegisteredService> {
+    std::size_t operator()(const cnstln::CHIRP::RegisteredService& service) const noexcept {
+        return std::hash<std::uint32_t>()(static_cast<std::uint32_t>(std::to_underlying(service.identifier)) << 16 | service.port);
+    }
+};
+
+/** Hash of a discovered service, consistent with :cpp:func:`DiscoveredService::operator==` */
+template <>
+struct hash<cnstln::CHIRP::DiscoveredService> {
+    std::size_t operator()(const cnstln::CHIRP::DiscoveredService& service) const noexcept {
+        return std::hash<cnstln::CHIRP::MD5Hash>()(service.host_id) ^
+               std::hash<cnstln::CHIRP::RegisteredService>()({service.identifier, service.port});
+    }
+};
+
+} // namespace std
@@ -1,22 +1,14 @@
 #include "Message.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <utility>
 
 #include "CHIRP/exceptions.hpp"
-#include "CHIRP/external/md5.h"
 
 using namespace cnstln::CHIRP;
 
-MD5Hash::MD5Hash(std::string_view string) {
-    auto hasher = Chocobo1::MD5();
-    hasher.addData(string.data(), string.length());
-    hasher.finalize();
-    // Swap output of hash with this to avoid copy
-    auto hash_copy = hasher.toArray();
-    this->swap(hash_copy);
-}
-
 std::string MD5Hash::to_string() const {
     std::string ret {};
     // Resize string to twice the hash length as two character needed per byte
@@ -32,87 +24,57 @@ std::string MD5Hash::to_string() const {
     return ret;
 }
 
-bool MD5Hash::operator<(const MD5Hash& other) const {
-    for (std::uint8_t n = 0; n < this->size(); ++n) {
-        if (this->at(n) < other[n]) {
-            return true;
+namespace {
+    // Load 8 bytes as big-endian word, such that words compare like their bytes lexicographically
+    std::uint64_t LoadWord(const std::uint8_t* bytes) {
+        std::uint64_t word {};
+        std::memcpy(&word, bytes, sizeof(word));
+        if constexpr (std::endian::native == std::endian::little) {
+            word = std::byteswap(word);
         }
+        return word;
     }
-    return false;
 }
 
-AssembledMessage::AssembledMessage(const std::vector<std::uint8_t>& byte_array) {
-    if (byte_array.size() != CHIRP_MESSAGE_LENGTH) {
-        throw DecodeError("Message length is not " + std::to_string(CHIRP_MESSAGE_LENGTH) + " bytes");
+std::strong_ordering MD5Hash::operator<=>(const MD5Hash& other) const {
+    const auto ord_upper = LoadWord(this->data()) <=> LoadWord(other.data());
+    if (std::is_neq(ord_upper)) {
+        return ord_upper;
     }
-    std::copy_n(byte_array.cbegin(), CHIRP_MESSAGE_LENGTH, this->begin());
+    return LoadWord(this->data() + 8) <=> LoadWord(other.data() + 8);
 }
 
-Message::Message(MessageType type, MD5Hash group_id, MD5Hash host_id, ServiceIdentifier service_id, Port port)
-  : type_(type), group_id_(std::move(group_id)), host_id_(std::move(host_id)), service_id_(service_id), port_(port) {}
-
-Message::Message(MessageType type, std::string_view group, std::string_view host, ServiceIdentifier service_id, Port port)
-  : Message(type, MD5Hash(group), MD5Hash(host), service_id, port) {}
+bool MD5Hash::operator<(const MD5Hash& other) const {
+    return std::is_lt(*this <=> other);
+}
 
-Message::Message(const AssembledMessage& assembled_message) {
-    // Header
-    if (assembled_message[0] != 'C' ||
-        assembled_message[1] != 'H' ||
-        assembled_message[2] != 'I' ||
-        assembled_message[3] != 'R' ||
-        assembled_message[4] != 'P' ||
-        assembled_message[5] != CHIRP_VERSION) {
-        throw DecodeError("Not a CHIRP v1 broadcast");
-    }
-    // Message Type
-    if (assembled_message[6] < std::to_underlying(MessageType::REQUEST) ||
-        assembled_message[6] > std::to_underlying(MessageType::DEPART)) {
-        throw DecodeError("Message Type invalid");
-    }
-    type_ = static_cast<MessageType>(assembled_message[6]);
-    // Group ID
-    for (std::uint8_t n = 0; n < 16; ++n) {
-        group_id_[n] = assembled_message[7+n];
-    }
-    // Host ID
-    for (std::uint8_t n = 0; n < 16; ++n) {
-        host_id_[n] = assembled_message[23+n];
+namespace {
+    // Error message of the exception thrown for a decode error
+    std::string DecodeErrorMessage(DecodeErrorCode error) {
+        switch (error) {
+        case DecodeErrorCode::INVALID_LENGTH: return "Message length is not " + std::to_string(CHIRP_MESSAGE_LENGTH) + " bytes";
+        case DecodeErrorCode::INVALID_HEADER: return "Not a CHIRP v1 broadcast";
+        case DecodeErrorCode::INVALID_TYPE: return "Message Type invalid";
+        case DecodeErrorCode::INVALID_SERVICE: return "Service Identifier invalid";
+        default: std::unreachable();
+        }
     }
-    // Service Identifier
-    if (assembled_message[39] < std::to_underlying(ServiceIdentifier::CONTROL) ||
-        assembled_message[39] > std::to_underlying(ServiceIdentifier::DATA)) {
-        throw DecodeError("Service Identifier invalid");
+
+    // Decode message, throwing on malformed input
+    Message DecodeOrThrow(std::span<const std::uint8_t> bytes) {
+        auto result = Message::TryDecode(bytes);
+        if (!result) {
+            throw DecodeError(DecodeErrorMessage(result.error()));
+        }
+        return result.value();
     }
-    service_id_ = static_cast<ServiceIdentifier>(assembled_message[39]);
-    // Port
-    port_ = assembled_message[40] + (static_cast<std::uint16_t>(assembled_message[41]) << 8);
 }
 
-AssembledMessage Message::Assemble() const {
-    AssembledMessage ret {};
-
-    // Header
-    ret[0] = 'C';
-    ret[1] = 'H';
-    ret[2] = 'I';
-    ret[3] = 'R';
-    ret[4] = 'P';
-    ret[5] = CHIRP_VERSION;
-    // Message Type
-    ret[6] = std::to_underlying(type_);
-    // Group Hash
-    for (std::uint8_t n = 0; n < 16; ++n) {
-        ret[7+n] = group_id_[n];
-    }
-    // Host Hash
-    for (std::uint8_t n = 0; n < 16; ++n) {
-        ret[23+n] = host_id_[n];
+AssembledMessage::AssembledMessage(const std::vector<std::uint8_t>& byte_array) {
+    if (byte_array.size() != CHIRP_MESSAGE_LENGTH) {
+        throw DecodeError(DecodeErrorMessage(DecodeErrorCode::INVALID_LENGTH));
     }
-    // Service Identifier
-    ret[39] = std::to_underlying(service_id_);
-    // Port
-    ret[40] = static_cast<std::uint8_t>(port_ & 0x00FF);
-    ret[41] = static_cast<std::uint8_t>((port_ >> 8) & 0x00FF);
-
-    return ret;
+    std::copy_n(byte_array.cbegin(), CHIRP_MESSAGE_LENGTH, this->begin());
 }
+
+Message::Message(const AssembledMessage& assembled_message) : Message(DecodeOrThrow(assembled_message)) {}
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
-#include <vector>
+#include <compare>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "CHIRP/config.hpp"
 #include "CHIRP/protocol_info.hpp"
+#include "CHIRP/external/md5.h"
 
 namespace cnstln {
 namespace CHIRP {
@@ -20,9 +30,32 @@ public:
     /**
      * Construct MD5 hash from a string
      *
+     * Can be evaluated at compile time.
+     *
      * @param string String from which to create the MD5 hash
      */
-    CHIRP_API MD5Hash(std::string_view string);
+    constexpr MD5Hash(std::string_view string) {
+        auto hasher = Chocobo1::MD5();
+        if (std::is_constant_evaluated()) {
+            // Data cannot be reinterpreted as bytes at compile time, add it byte by byte
+            for (const auto character : string) {
+                const auto byte = static_cast<std::uint8_t>(character);
+                hasher.addData(std::span<const std::uint8_t>(&byte, 1));
+            }
+        }
+        else {
+            hasher.addData(string.data(), string.length());
+        }
+        hasher.finalize();
+        std::ranges::copy(hasher.toArray(), this->begin());
+    }
+
+    /**
+     * Construct MD5 hash from its bytes
+     *
+     * @param bytes Bytes of the MD5 hash, e.g. from :cpp:func:`MessageView::GetGroupID`
+     */
+    constexpr explicit MD5Hash(std::span<const std::uint8_t, 16> bytes) { std::ranges::copy(bytes, this->begin()); }
 
     /**
      * Convert MD5 hash to an human readable string
@@ -31,6 +64,14 @@ public:
      */
     CHIRP_API std::string to_string() const;
 
+    /**
+     * Compare MD5 hashes lexicographically by their bytes
+     *
+     * The bytes are compared as two big-endian 64-bit words instead of byte by byte.
+     */
+    CHIRP_API std::strong_ordering operator<=>(const MD5Hash& other) const;
+
+    /** Check if the MD5 hash is lexicographically smaller than another one, see :cpp:func:`operator<=>` */
     CHIRP_API bool operator<(const MD5Hash& other) const;
 };
 
@@ -48,6 +89,197 @@ public:
     CHIRP_API AssembledMessage(const std::vector<std::uint8_t>& byte_array);
 };
 
+/** Reason why a CHIRP message could not be decoded */
+enum class DecodeErrorCode : std::uint8_t {
+    /**
+     * The message length is not :cpp:var:`CHIRP_MESSAGE_LENGTH`, or does not match the number of services of a CHIRP v2
+     * message
+     */
+    INVALID_LENGTH = 1,
+
+    /** The message header does not match the CHIRP specification */
+    INVALID_HEADER = 2,
+
+    /** The message has an unknown :cpp:enum:`MessageType` */
+    INVALID_TYPE = 3,
+
+    /** The message has an unknown :cpp:enum:`ServiceIdentifier` */
+    INVALID_SERVICE = 4,
+};
+
+/**
+ * Non-owning view of an assembled CHIRP message
+ *
+ * Fields are decoded in place when accessed, such that the message is neither copied nor required to outlive a decoded
+ * :cpp:class:`Message`. All accessors except :cpp:func:`IsValid` assume that the message is valid.
+ */
+class MessageView {
+public:
+    /** Offset of the group ID in an assembled message */
+    static constexpr std::size_t GROUP_ID_OFFSET = 7;
+
+    /** Offset of the host ID in an assembled message */
+    static constexpr std::size_t HOST_ID_OFFSET = 23;
+
+    /**
+     * @param bytes Bytes of the assembled message, have to outlive the view
+     */
+    constexpr MessageView(std::span<const std::uint8_t, CHIRP_MESSAGE_LENGTH> bytes) : bytes_(bytes) {}
+
+    /**
+     * Validate the message without throwing
+     *
+     * @return Reason why the message is not a valid CHIRP message, or an empty optional if the message is valid
+     */
+    constexpr std::optional<DecodeErrorCode> Validate() const {
+        if (bytes_[0] != 'C' || bytes_[1] != 'H' || bytes_[2] != 'I' || bytes_[3] != 'R' || bytes_[4] != 'P' ||
+            bytes_[5] != CHIRP_VERSION) {
+            return DecodeErrorCode::INVALID_HEADER;
+        }
+        if (bytes_[6] < std::to_underlying(MessageType::REQUEST) || bytes_[6] > std::to_underlying(MessageType::DEPART)) {
+            return DecodeErrorCode::INVALID_TYPE;
+        }
+        if (bytes_[39] < std::to_underlying(ServiceIdentifier::CONTROL) || bytes_[39] > std::to_underlying(ServiceIdentifier::DATA)) {
+            return DecodeErrorCode::INVALID_SERVICE;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Check if the message is a valid CHIRP message
+     *
+     * @return If the message header matches the CHIRP specification, and the message has a known :cpp:enum:`MessageType`
+     *         and :cpp:enum:`ServiceIdentifier`
+     */
+    constexpr bool IsValid() const { return !Validate().has_value(); }
+
+    /** Return the message type */
+    constexpr MessageType GetType() const { return static_cast<MessageType>(bytes_[6]); }
+
+    /** Return the bytes of the group ID of the message */
+    constexpr std::span<const std::uint8_t, 16> GetGroupID() const { return bytes_.subspan<GROUP_ID_OFFSET, 16>(); }
+
+    /** Return the bytes of the host ID of the message */
+    constexpr std::span<const std::uint8_t, 16> GetHostID() const { return bytes_.subspan<HOST_ID_OFFSET, 16>(); }
+
+    /** Check if the message has the given group ID, without copying the group ID */
+    constexpr bool HasGroupID(const MD5Hash& group_id) const { return std::ranges::equal(GetGroupID(), group_id); }
+
+    /** Check if the message has the given host ID, without copying the host ID */
+    constexpr bool HasHostID(const MD5Hash& host_id) const { return std::ranges::equal(GetHostID(), host_id); }
+
+    /** Return the service identifier of the message */
+    constexpr ServiceIdentifier GetServiceIdentifier() const { return static_cast<ServiceIdentifier>(bytes_[39]); }
+
+    /** Return the service port of the message */
+    constexpr Port GetPort() const { return static_cast<Port>(bytes_[40] | (bytes_[41] << 8)); }
+
+private:
+    std::span<const std::uint8_t, CHIRP_MESSAGE_LENGTH> bytes_;
+};
+
+/**
+ * Non-owning view of an assembled CHIRP v2 message with multiple services
+ *
+ * The header of CHIRP v2 messages matches the CHIRP v1 header with :cpp:var:`CHIRP_VERSION_2` as version, followed by
+ * the number of services. Each service is encoded as service identifier and port like in CHIRP v1 messages. Fields
+ * are decoded in place when accessed. All accessors except :cpp:func:`IsValid` assume that the message is valid.
+ */
+class MultiMessageView {
+public:
+    /** Offset of the number of services in an assembled CHIRP v2 message */
+    static constexpr std::size_t SERVICE_COUNT_OFFSET = 39;
+
+    /**
+     * @param bytes Bytes of the assembled message with arbitrary length, have to outlive the view
+     */
+    constexpr MultiMessageView(std::span<const std::uint8_t> bytes) : bytes_(bytes) {}
+
+    /**
+     * Validate the message without throwing
+     *
+     * @return Reason why the message is not a valid CHIRP v2 message, or an empty optional if the message is valid
+     */
+    constexpr std::optional<DecodeErrorCode> Validate() const {
+        if (bytes_.size() < CHIRP_V2_HEADER_LENGTH) {
+            return DecodeErrorCode::INVALID_LENGTH;
+        }
+        if (bytes_[0] != 'C' || bytes_[1] != 'H' || bytes_[2] != 'I' || bytes_[3] != 'R' || bytes_[4] != 'P' ||
+            bytes_[5] != CHIRP_VERSION_2) {
+            return DecodeErrorCode::INVALID_HEADER;
+        }
+        if (bytes_[6] < std::to_underlying(MessageType::REQUEST) || bytes_[6] > std::to_underlying(MessageType::DEPART)) {
+            return DecodeErrorCode::INVALID_TYPE;
+        }
+        const auto service_count = GetServiceCount();
+        if (service_count == 0 || service_count > CHIRP_V2_MAX_SERVICES ||
+            bytes_.size() != CHIRP_V2_HEADER_LENGTH + service_count * CHIRP_V2_SERVICE_LENGTH) {
+            return DecodeErrorCode::INVALID_LENGTH;
+        }
+        for (std::size_t n = 0; n < service_count; ++n) {
+            const auto service_id = bytes_[CHIRP_V2_HEADER_LENGTH + n * CHIRP_V2_SERVICE_LENGTH];
+            if (service_id < std::to_underlying(ServiceIdentifier::CONTROL) || service_id > std::to_underlying(ServiceIdentifier::DATA)) {
+                return DecodeErrorCode::INVALID_SERVICE;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Check if the message is a valid CHIRP v2 message
+     *
+     * @return If the message header matches the CHIRP v2 specification, the length matches the number of services, and
+     *         the message has a known :cpp:enum:`MessageType` and only known :cpp:enum:`ServiceIdentifier`
+     */
+    constexpr bool IsValid() const { return !Validate().has_value(); }
+
+    /** Return the message type */
+    constexpr MessageType GetType() const { return static_cast<MessageType>(bytes_[6]); }
+
+    /** Return the bytes of the group ID of the message */
+    constexpr std::span<const std::uint8_t, 16> GetGroupID() const {
+        return bytes_.subspan<MessageView::GROUP_ID_OFFSET, 16>();
+    }
+
+    /** Return the bytes of the host ID of the message */
+    constexpr std::span<const std::uint8_t, 16> GetHostID() const {
+        return bytes_.subspan<MessageView::HOST_ID_OFFSET, 16>();
+    }
+
+    /** Check if the message has the given group ID, without copying the group ID */
+    constexpr bool HasGroupID(const MD5Hash& group_id) const { return std::ranges::equal(GetGroupID(), group_id); }
+
+    /** Check if the message has the given host ID, without copying the host ID */
+    constexpr bool HasHostID(const MD5Hash& host_id) const { return std::ranges::equal(GetHostID(), host_id); }
+
+    /** Return the number of services in the message */
+    constexpr std::size_t GetServiceCount() const { return bytes_[SERVICE_COUNT_OFFSET]; }
+
+    /**
+     * Return the service identifier of a service in the message
+     *
+     * @param index Index of the service, smaller than :cpp:func:`GetServiceCount`
+     */
+    constexpr ServiceIdentifier GetServiceIdentifier(std::size_t index) const {
+        return static_cast<ServiceIdentifier>(bytes_[CHIRP_V2_HEADER_LENGTH + index * CHIRP_V2_SERVICE_LENGTH]);
+    }
+
+    /**
+     * Return the port of a service in the message
+     *
+     * @param index Index of the service, smaller than :cpp:func:`GetServiceCount`
+     */
+    constexpr Port GetPort(std::size_t index) const {
+        const auto offset = CHIRP_V2_HEADER_LENGTH + index * CHIRP_V2_SERVICE_LENGTH;
+        return static_cast<Port>(bytes_[offset + 1] | (bytes_[offset + 2] << 8));
+    }
+
+private:
+    std::span<const std::uint8_t> bytes_;
+};
+
+class DecodeResult;
+
 /** CHIRP message */
 class Message {
 public:
@@ -60,7 +292,8 @@ public:
      * @param service_id
      * @param port
      */
-    CHIRP_API Message(MessageType type, MD5Hash group_id, MD5Hash host_id, ServiceIdentifier service_id, Port port);
+    constexpr Message(MessageType type, MD5Hash group_id, MD5Hash host_id, ServiceIdentifier service_id, Port port)
+      : type_(type), group_id_(std::move(group_id)), host_id_(std::move(host_id)), service_id_(service_id), port_(port) {}
 
     /**
      * Construct new CHIRP message using strings for group and host ID
@@ -71,7 +304,8 @@ public:
      * @param service_id
      * @param port
      */
-    CHIRP_API Message(MessageType type, std::string_view group, std::string_view host, ServiceIdentifier service_id, Port port);
+    constexpr Message(MessageType type, std::string_view group, std::string_view host, ServiceIdentifier service_id, Port port)
+      : Message(type, MD5Hash(group), MD5Hash(host), service_id, port) {}
 
     /**
      * Constructor for a CHIRP message from an assembled message
@@ -82,6 +316,17 @@ public:
      */
     CHIRP_API Message(const AssembledMessage& assembled_message);
 
+    /**
+     * Decode a CHIRP message without throwing
+     *
+     * Malformed input is reported via the returned result instead of a :cpp:class:`DecodeError`, such that decoding
+     * untrusted traffic does not pay for exception unwinding.
+     *
+     * @param bytes Bytes of the message with arbitrary length
+     * @return Decoded message, or the reason why the message could not be decoded
+     */
+    static constexpr DecodeResult TryDecode(std::span<const std::uint8_t> bytes);
+
     /** Return the message type */
     constexpr MessageType GetType() const { return type_; }
 
@@ -97,8 +342,31 @@ public:
     /** Return the service port of the message */
     constexpr Port GetPort() const { return port_; }
 
-    /** Assemble message to byte array */
-    CHIRP_API AssembledMessage Assemble() const;
+    /** Assemble message to byte array, can be evaluated at compile time */
+    constexpr AssembledMessage Assemble() const {
+        AssembledMessage ret {};
+
+        // Header
+        ret[0] = 'C';
+        ret[1] = 'H';
+        ret[2] = 'I';
+        ret[3] = 'R';
+        ret[4] = 'P';
+        ret[5] = CHIRP_VERSION;
+        // Message Type
+        ret[6] = std::to_underlying(type_);
+        // Group Hash
+        std::ranges::copy(group_id_, ret.begin() + MessageView::GROUP_ID_OFFSET);
+        // Host Hash
+        std::ranges::copy(host_id_, ret.begin() + MessageView::HOST_ID_OFFSET);
+        // Service Identifier
+        ret[39] = std::to_underlying(service_id_);
+        // Port
+        ret[40] = static_cast<std::uint8_t>(port_ & 0x00FF);
+        ret[41] = static_cast<std::uint8_t>((port_ >> 8) & 0x00FF);
+
+        return ret;
+    }
 
 private:
     MessageType type_;
@@ -108,5 +376,217 @@ private:
     Port port_;
 };
 
+/**
+ * Result of :cpp:func:`Message::TryDecode`, either a decoded message or the reason why decoding failed
+ *
+ * Follows the interface of ``std::expected<Message, DecodeErrorCode>``.
+ */
+class DecodeResult {
+public:
+    /** @param message Decoded message */
+    constexpr DecodeResult(Message message) : result_(std::move(message)) {}
+
+    /** @param error Reason why decoding failed */
+    constexpr DecodeResult(DecodeErrorCode error) : result_(error) {}
+
+    /** Return if the message was decoded successfully */
+    constexpr bool has_value() const { return std::holds_alternative<Message>(result_); }
+
+    /** Return if the message was decoded successfully */
+    constexpr explicit operator bool() const { return has_value(); }
+
+    /**
+     * Return the decoded message
+     *
+     * @throws std::bad_variant_access If decoding failed
+     */
+    constexpr const Message& value() const { return std::get<Message>(result_); }
+
+    /** Return the decoded message, see :cpp:func:`value` */
+    constexpr const Message& operator*() const { return std::get<Message>(result_); }
+
+    /** Access the decoded message, see :cpp:func:`value` */
+    constexpr const Message* operator->() const { return &std::get<Message>(result_); }
+
+    /**
+     * Return the reason why decoding failed
+     *
+     * @throws std::bad_variant_access If decoding succeeded
+     */
+    constexpr DecodeErrorCode error() const { return std::get<DecodeErrorCode>(result_); }
+
+private:
+    std::variant<Message, DecodeErrorCode> result_;
+};
+
+constexpr DecodeResult Message::TryDecode(std::span<const std::uint8_t> bytes) {
+    if (bytes.size() != CHIRP_MESSAGE_LENGTH) {
+        return DecodeErrorCode::INVALID_LENGTH;
+    }
+    const MessageView view {bytes.first<CHIRP_MESSAGE_LENGTH>()};
+    if (const auto error = view.Validate()) {
+        return error.value();
+    }
+    return Message(view.GetType(), MD5Hash(view.GetGroupID()), MD5Hash(view.GetHostID()), view.GetServiceIdentifier(), view.GetPort());
+}
+
+/** CHIRP v2 message assembled to bytes, with a length depending on the number of services */
+class AssembledMultiMessage {
+public:
+    constexpr AssembledMultiMessage() {}
+
+    /** Return pointer to the bytes of the assembled message */
+    constexpr const std::uint8_t* data() const { return bytes_.data(); }
+
+    /** Return the length of the assembled message in bytes */
+    constexpr std::size_t size() const { return length_; }
+
+    constexpr const std::uint8_t* begin() const { return bytes_.data(); }
+    constexpr const std::uint8_t* end() const { return bytes_.data() + length_; }
+
+private:
+    friend class MultiMessage;
+
+    std::array<std::uint8_t, CHIRP_V2_MAX_MESSAGE_LENGTH> bytes_ {};
+    std::size_t length_ {0};
+};
+
+/**
+ * CHIRP v2 message announcing multiple services of a host at once
+ *
+ * Packs up to :cpp:var:`CHIRP_V2_MAX_SERVICES` services of the same :cpp:enum:`MessageType` into a single broadcast,
+ * see :cpp:class:`MultiMessageView` for the layout. Hosts only supporting CHIRP v1 ignore these messages, thus they
+ * should only be sent after all hosts announced support for CHIRP v2 (see :cpp:func:`Manager::EnableProtocolV2`).
+ */
+class MultiMessage {
+public:
+    /**
+     * Construct new CHIRP v2 message without services
+     *
+     * @param type
+     * @param group_id
+     * @param host_id
+     */
+    constexpr MultiMessage(MessageType type, MD5Hash group_id, MD5Hash host_id)
+      : type_(type), group_id_(std::move(group_id)), host_id_(std::move(host_id)) {}
+
+    /**
+     * Construct new CHIRP v2 message without services using strings for group and host ID
+     *
+     * @param type
+     * @param group Name of the group (converted to group ID using :cpp:class:`MD5Hash`)
+     * @param host Name of the host (converted to host ID using :cpp:class:`MD5Hash`)
+     */
+    constexpr MultiMessage(MessageType type, std::string_view group, std::string_view host)
+      : MultiMessage(type, MD5Hash(group), MD5Hash(host)) {}
+
+    /**
+     * Construct CHIRP v2 message from a view of an assembled message
+     *
+     * @param view View of a valid assembled message, see :cpp:func:`MultiMessageView::IsValid`
+     */
+    constexpr explicit MultiMessage(const MultiMessageView& view)
+      : MultiMessage(view.GetType(), MD5Hash(view.GetGroupID()), MD5Hash(view.GetHostID())) {
+        for (std::size_t n = 0; n < view.GetServiceCount(); ++n) {
+            AddService(view.GetServiceIdentifier(n), view.GetPort(n));
+        }
+    }
+
+    /**
+     * Add a service to the message
+     *
+     * @param service_id
+     * @param port
+     * @retval true If the service was added
+     * @retval false If the message already contains :cpp:var:`CHIRP_V2_MAX_SERVICES` services
+     */
+    constexpr bool AddService(ServiceIdentifier service_id, Port port) {
+        if (service_count_ == CHIRP_V2_MAX_SERVICES) {
+            return false;
+        }
+        service_ids_[service_count_] = service_id;
+        ports_[service_count_] = port;
+        ++service_count_;
+        return true;
+    }
+
+    /** Return the message type */
+    constexpr MessageType GetType() const { return type_; }
+
+    /** Return the group ID of the message */
+    constexpr MD5Hash GetGroupID() const { return group_id_; }
+
+    /** Return the host ID of the message */
+    constexpr MD5Hash GetHostID() const { return host_id_; }
+
+    /** Return the number of services in the message */
+    constexpr std::size_t GetServiceCount() const { return service_count_; }
+
+    /**
+     * Return the CHIRP v1 message equivalent to a service in the message
+     *
+     * @param index Index of the service, smaller than :cpp:func:`GetServiceCount`
+     */
+    constexpr Message GetMessage(std::size_t index) const {
+        return {type_, group_id_, host_id_, service_ids_[index], ports_[index]};
+    }
+
+    /** Assemble message to bytes, can be evaluated at compile time */
+    constexpr AssembledMultiMessage Assemble() const {
+        AssembledMultiMessage ret {};
+        auto& bytes = ret.bytes_;
+
+        // Header
+        bytes[0] = 'C';
+        bytes[1] = 'H';
+        bytes[2] = 'I';
+        bytes[3] = 'R';
+        bytes[4] = 'P';
+        bytes[5] = CHIRP_VERSION_2;
+        // Message Type
+        bytes[6] = std::to_underlying(type_);
+        // Group Hash
+        std::ranges::copy(group_id_, bytes.begin() + MessageView::GROUP_ID_OFFSET);
+        // Host Hash
+        std::ranges::copy(host_id_, bytes.begin() + MessageView::HOST_ID_OFFSET);
+        // Number of services
+        bytes[MultiMessageView::SERVICE_COUNT_OFFSET] = static_cast<std::uint8_t>(service_count_);
+        // Service Identifier and Port of each service
+        for (std::size_t n = 0; n < service_count_; ++n) {
+            const auto offset = CHIRP_V2_HEADER_LENGTH + n * CHIRP_V2_SERVICE_LENGTH;
+            bytes[offset] = std::to_underlying(service_ids_[n]);
+            bytes[offset + 1] = static_cast<std::uint8_t>(ports_[n] & 0x00FF);
+            bytes[offset + 2] = static_cast<std::uint8_t>((ports_[n] >> 8) & 0x00FF);
+        }
+        ret.length_ = CHIRP_V2_HEADER_LENGTH + service_count_ * CHIRP_V2_SERVICE_LENGTH;
+
+        return ret;
+    }
+
+private:
+    MessageType type_;
+    MD5Hash group_id_;
+    MD5Hash host_id_;
+    std::array<ServiceIdentifier, CHIRP_V2_MAX_SERVICES> service_ids_ {};
+    std::array<Port, CHIRP_V2_MAX_SERVICES> ports_ {};
+    std::size_t service_count_ {0};
+};
+
 } // namespace CHIRP
 } // namespace cnstln
+
+namespace std {
+
+/** Hash of an MD5 hash, made of its leading bytes since MD5 hashes are already uniformly distributed */
+template <>
+struct hash<cnstln::CHIRP::MD5Hash> {
+    constexpr std::size_t operator()(const cnstln::CHIRP::MD5Hash& md5_hash) const noexcept {
+        std::size_t hash = 0;
+        for (std::size_t n = 0; n < sizeof(std::size_t); ++n) {
+            hash = (hash << 8) | md5_hash[n];
+        }
+        return hash;
+    }
+};
+
+} // namespace std
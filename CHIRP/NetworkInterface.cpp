@@ -0,0 +1,52 @@
+#include "NetworkInterface.hpp"
+
+#if !(defined _WIN32 && !defined __CYGWIN__)
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#endif
+
+using namespace cnstln::CHIRP;
+
+#if (defined _WIN32 && !defined __CYGWIN__)
+
+std::vector<NetworkInterface> cnstln::CHIRP::GetNetworkInterfaces() {
+    // Interface enumeration not implemented
+    return {};
+}
+
+#else
+
+namespace {
+    asio::ip::address_v4 ToAddress(const sockaddr* sock_addr) {
+        const auto* sock_addr_in = reinterpret_cast<const sockaddr_in*>(sock_addr);
+        return asio::ip::address_v4(ntohl(sock_addr_in->sin_addr.s_addr));
+    }
+}
+
+std::vector<NetworkInterface> cnstln::CHIRP::GetNetworkInterfaces() {
+    std::vector<NetworkInterface> interfaces {};
+
+    ifaddrs* if_addrs = nullptr;
+    if (::getifaddrs(&if_addrs) != 0) {
+        return interfaces;
+    }
+    for (const auto* if_addr = if_addrs; if_addr != nullptr; if_addr = if_addr->ifa_next) {
+        // Only IPv4 interfaces which are up and have a broadcast address
+        if (if_addr->ifa_addr == nullptr || if_addr->ifa_addr->sa_family != AF_INET) {
+            continue;
+        }
+        if ((if_addr->ifa_flags & IFF_UP) == 0 || (if_addr->ifa_flags & IFF_BROADCAST) == 0 || if_addr->ifa_broadaddr == nullptr) {
+            continue;
+        }
+        interfaces.push_back({if_addr->ifa_name,
+                              ::if_nametoindex(if_addr->ifa_name),
+                              ToAddress(if_addr->ifa_addr),
+                              ToAddress(if_addr->ifa_broadaddr)});
+    }
+    ::freeifaddrs(if_addrs);
+
+    return interfaces;
+}
+
+#endif
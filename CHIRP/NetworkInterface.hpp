@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "CHIRP/config.hpp"
+
+namespace cnstln {
+namespace CHIRP {
+
+/** Network interface on which CHIRP broadcasts can be sent and received */
+struct NetworkInterface {
+    /** Name of the interface */
+    std::string name;
+
+    /** Index of the interface as used by the kernel */
+    unsigned int index;
+
+    /** Address of the host on the interface */
+    asio::ip::address address;
+
+    /** Broadcast address of the interface */
+    asio::ip::address broadcast_address;
+};
+
+/**
+ * Get all network interfaces which are up and support IPv4 broadcasts
+ *
+ * Interfaces with several IPv4 addresses are listed once per address. Not supported on Windows.
+ *
+ * @return List of network interfaces, empty if the interfaces cannot be enumerated on this platform
+ */
+CHIRP_API std::vector<NetworkInterface> GetNetworkInterfaces();
+
+} // namespace CHIRP
+} // namespace cnstln
@@ -0,0 +1,128 @@
+#include "TimingWheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+using namespace cnstln::CHIRP;
+
+TimingWheel::TimerID TimingWheel::Add(std::uint64_t expiry, std::uint32_t value) {
+    TimerID node {};
+    if (free_ != NO_TIMER) {
+        node = free_;
+        free_ = nodes_[node].next;
+    }
+    else {
+        node = static_cast<TimerID>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[node].expiry = expiry;
+    nodes_[node].value = value;
+    Place(node);
+    ++size_;
+    return node;
+}
+
+void TimingWheel::Reschedule(TimerID timer, std::uint64_t expiry) {
+    Unlink(timer);
+    nodes_[timer].expiry = expiry;
+    Place(timer);
+}
+
+void TimingWheel::Remove(TimerID timer) {
+    Unlink(timer);
+    Free(timer);
+}
+
+void TimingWheel::Clear() {
+    nodes_.clear();
+    heads_.fill(NO_TIMER);
+    occupied_.fill(0);
+    free_ = NO_TIMER;
+    size_ = 0;
+}
+
+std::optional<std::uint64_t> TimingWheel::GetNextTick() const {
+    std::optional<std::uint64_t> next_tick {};
+    for (std::size_t level = 0; level < LEVELS; ++level) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+        // Distance from current slot to next occupied slot, the current slot itself is only reached after a full rotation
+        const auto shift = SLOT_BITS * level;
+        const auto current_slot = static_cast<int>((tick_ >> shift) % SLOTS);
+        const auto distance = std::countr_zero(std::rotr(occupied_[level], current_slot + 1)) + 1;
+        const auto tick = ((tick_ >> shift) + static_cast<std::uint64_t>(distance)) << shift;
+        next_tick = std::min(next_tick.value_or(tick), tick);
+    }
+    return next_tick;
+}
+
+void TimingWheel::Cascade() {
+    // Start with last wheel such that timers moved to the current slot of a lower wheel are moved again
+    for (auto level = LEVELS - 1; level > 0; --level) {
+        const auto shift = SLOT_BITS * level;
+        if (tick_ % (std::uint64_t(1) << shift) != 0) {
+            continue;
+        }
+        auto node = DetachSlot(level * SLOTS + (tick_ >> shift) % SLOTS);
+        while (node != NO_TIMER) {
+            const auto next = nodes_[node].next;
+            Place(node);
+            node = next;
+        }
+    }
+}
+
+void TimingWheel::Place(TimerID node) {
+    // Timers which already expired are placed in the next slot
+    const auto expiry = std::max(nodes_[node].expiry, tick_ + 1);
+    const auto delta = std::min(expiry - tick_, RANGE - 1);
+    std::size_t level = 0;
+    while (delta >> (SLOT_BITS * (level + 1)) != 0) {
+        ++level;
+    }
+    const auto slot_tick = tick_ + delta;
+    const auto slot_in_level = (slot_tick >> (SLOT_BITS * level)) % SLOTS;
+    const auto slot = level * SLOTS + slot_in_level;
+
+    auto& head = heads_[slot];
+    nodes_[node].prev = NO_TIMER;
+    nodes_[node].next = head;
+    nodes_[node].slot = static_cast<std::uint32_t>(slot);
+    if (head != NO_TIMER) {
+        nodes_[head].prev = node;
+    }
+    head = node;
+    occupied_[level] |= std::uint64_t(1) << slot_in_level;
+}
+
+void TimingWheel::Unlink(TimerID node) {
+    const auto& current = nodes_[node];
+    if (current.prev != NO_TIMER) {
+        nodes_[current.prev].next = current.next;
+    }
+    else {
+        heads_[current.slot] = current.next;
+        if (current.next == NO_TIMER) {
+            occupied_[current.slot / SLOTS] &= ~(std::uint64_t(1) << (current.slot % SLOTS));
+        }
+    }
+    if (current.next != NO_TIMER) {
+        nodes_[current.next].prev = current.prev;
+    }
+}
+
+TimingWheel::TimerID TimingWheel::DetachSlot(std::size_t slot) {
+    occupied_[slot / SLOTS] &= ~(std::uint64_t(1) << (slot % SLOTS));
+    return std::exchange(heads_[slot], NO_TIMER);
+}
+
+void TimingWheel::Free(TimerID node) {
+    nodes_[node].next = free_;
+    free_ = node;
+    --size_;
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "CHIRP/config.hpp"
+
+namespace cnstln {
+namespace CHIRP {
+
+/**
+ * Hierarchical timing wheel for timers with a resolution of one tick
+ *
+ * Timers are kept in intrusive lists in the slots of four wheels of 64 slots each, where each slot of a wheel spans a full
+ * rotation of the previous wheel. When the previous wheel completes a rotation, the timers of the next slot are moved
+ * down to the wheel matching their remaining time. Adding, rescheduling and removing a timer thus take constant time,
+ * independent of the number of timers, and no timer is visited more than once per wheel. Timers further than
+ * :cpp:member:`RANGE` ticks in the future are kept in the last wheel until they are within range. Which slots hold timers
+ * is tracked in a bit mask per wheel, such that the next tick at which timers have to be moved or expire is found without
+ * scanning the slots. This class is not thread-safe.
+ */
+class TimingWheel {
+public:
+    /** Identifier of a timer, reused after the timer expired or was removed */
+    using TimerID = std::uint32_t;
+
+    /** Timer ID that does not refer to any timer */
+    static constexpr TimerID NO_TIMER = std::numeric_limits<TimerID>::max();
+
+    /** Number of wheels */
+    static constexpr std::size_t LEVELS = 4;
+
+    /** Number of bits of the tick covered by the slots of a wheel */
+    static constexpr std::size_t SLOT_BITS = 6;
+
+    /** Number of slots per wheel */
+    static constexpr std::size_t SLOTS = std::size_t(1) << SLOT_BITS;
+
+    /** Number of ticks covered by all wheels */
+    static constexpr std::uint64_t RANGE = std::uint64_t(1) << (SLOT_BITS * LEVELS);
+
+    /**
+     * Add a timer
+     *
+     * @param expiry Tick at which the timer expires, timers with a tick that already passed expire on the next tick
+     * @param value Arbitrary value passed back when the timer expires
+     * @return Timer ID
+     */
+    CHIRP_API TimerID Add(std::uint64_t expiry, std::uint32_t value);
+
+    /**
+     * Change the tick at which a timer expires
+     *
+     * @param timer Timer ID of a timer that has not expired yet
+     * @param expiry New tick at which the timer expires
+     */
+    CHIRP_API void Reschedule(TimerID timer, std::uint64_t expiry);
+
+    /**
+     * Remove a timer
+     *
+     * @param timer Timer ID of a timer that has not expired yet
+     */
+    CHIRP_API void Remove(TimerID timer);
+
+    /**
+     * Change the value of a timer
+     *
+     * @param timer Timer ID of a timer that has not expired yet
+     * @param value New value passed back when the timer expires
+     */
+    void SetValue(TimerID timer, std::uint32_t value) { nodes_[timer].value = value; }
+
+    /** Remove all timers */
+    CHIRP_API void Clear();
+
+    /** Return the number of timers */
+    std::size_t Size() const { return size_; }
+
+    /** Return the current tick */
+    std::uint64_t GetTick() const { return tick_; }
+
+    /**
+     * Return the next tick at which :cpp:func:`Advance` has work to do
+     *
+     * This is the earliest tick at which either timers expire or timers are moved to a lower wheel, thus it can be earlier
+     * than the next expiry.
+     *
+     * @return Next tick at which timers expire or move, no value if there are no timers
+     */
+    CHIRP_API std::optional<std::uint64_t> GetNextTick() const;
+
+    /**
+     * Advance the current tick and expire all timers up to this tick
+     *
+     * Ticks at which nothing has to be done are skipped. Expired timers are removed before ``expire`` is called with their
+     * value, thus ``expire`` may add timers or change the value of other timers, but must not remove other timers.
+     *
+     * @param tick Tick to advance to, ignored if not after the current tick
+     * @param expire Function called with the value of each expired timer
+     */
+    template <typename Expire> void Advance(std::uint64_t tick, Expire&& expire) {
+        while (tick_ < tick) {
+            const auto next_tick = GetNextTick();
+            if (!next_tick.has_value() || next_tick.value() > tick) {
+                tick_ = tick;
+                break;
+            }
+            tick_ = next_tick.value();
+            Cascade();
+
+            // Expire timers of current slot of first wheel
+            auto node = DetachSlot(tick_ % SLOTS);
+            while (node != NO_TIMER) {
+                const auto next = nodes_[node].next;
+                if (nodes_[node].expiry <= tick_) {
+                    const auto value = nodes_[node].value;
+                    Free(node);
+                    expire(value);
+                }
+                else {
+                    // Timer beyond range of all wheels
+                    Place(node);
+                }
+                node = next;
+            }
+        }
+    }
+
+private:
+    /** Move timers of the current slots of all wheels after the first wheel to the wheel matching their remaining time */
+    CHIRP_API void Cascade();
+
+    /**
+     * Insert a timer into the slot matching its expiry
+     *
+     * @param node Timer ID of a timer not in any slot
+     */
+    CHIRP_API void Place(TimerID node);
+
+    /**
+     * Remove a timer from its slot
+     *
+     * @param node Timer ID of a timer in a slot
+     */
+    void Unlink(TimerID node);
+
+    /**
+     * Remove all timers from a slot
+     *
+     * @param slot Index of the slot over all wheels
+     * @return Timer ID of the first timer of the slot, the timers stay linked via :cpp:member:`Node::next`
+     */
+    CHIRP_API TimerID DetachSlot(std::size_t slot);
+
+    /**
+     * Return a timer to the free list
+     *
+     * @param node Timer ID of a timer not in any slot
+     */
+    CHIRP_API void Free(TimerID node);
+
+private:
+    /** Timer */
+    struct Node {
+        /** Tick at which the timer expires */
+        std::uint64_t expiry;
+
+        /** Previous timer in the slot, or NO_TIMER if first */
+        TimerID prev;
+
+        /** Next timer in the slot or the free list, or NO_TIMER if last */
+        TimerID next;
+
+        /** Value passed back on expiry */
+        std::uint32_t value;
+
+        /** Index of the slot over all wheels */
+        std::uint32_t slot;
+    };
+
+    /** Timers, including unused ones in the free list */
+    std::vector<Node> nodes_;
+
+    /** First timer of each slot over all wheels */
+    std::array<TimerID, SLOTS * LEVELS> heads_ {[] {
+        std::array<TimerID, SLOTS * LEVELS> heads {};
+        heads.fill(NO_TIMER);
+        return heads;
+    }()};
+
+    /** Bit mask of the slots holding timers, per wheel */
+    std::array<std::uint64_t, LEVELS> occupied_ {};
+
+    /** First unused timer */
+    TimerID free_ {NO_TIMER};
+
+    /** Number of timers */
+    std::size_t size_ {0};
+
+    /** Current tick */
+    std::uint64_t tick_ {0};
+};
+
+} // namespace CHIRP
+} // namespace cnstln
@@ -41,3 +41,32 @@ namespace std{
 }
 }
 #endif
+
+// std::byteswap
+#ifndef __cpp_lib_byteswap
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+namespace std {
+template <std::integral T>
+constexpr T byteswap(T value) noexcept {
+    #ifdef __GNUC__
+    if constexpr (sizeof(T) == 8) {
+        return static_cast<T>(__builtin_bswap64(static_cast<std::uint64_t>(value)));
+    }
+    else if constexpr (sizeof(T) == 4) {
+        return static_cast<T>(__builtin_bswap32(static_cast<std::uint32_t>(value)));
+    }
+    else if constexpr (sizeof(T) == 2) {
+        return static_cast<T>(__builtin_bswap16(static_cast<std::uint16_t>(value)));
+    }
+    #endif
+    auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+    std::ranges::reverse(bytes);
+    return std::bit_cast<T>(bytes);
+}
+}
+#endif
@@ -331,7 +331,7 @@ namespace MD5_NS
 		return (*this);
 	}
 
-	std::string MD5::to_string() const
+	inline std::string MD5::to_string() const
 	{
 		const auto digest = toArray();
 		std::string ret;
@@ -350,7 +350,7 @@ namespace MD5_NS
 		return ret;
 	}
 
-	std::vector<MD5::Byte> MD5::toVector() const
+	inline std::vector<MD5::Byte> MD5::toVector() const
 	{
 		const auto digest = toArray();
 		return {digest.begin(), digest.end()};
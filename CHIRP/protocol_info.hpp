@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace cnstln {
@@ -22,6 +23,21 @@ constexpr Port CHIRP_PORT = 7123;
 /** CHIRP Message length in bytes */
 constexpr std::size_t CHIRP_MESSAGE_LENGTH = 42;
 
+/** Version of CHIRP protocol with multiple services per message, see :cpp:class:`MultiMessage` */
+constexpr std::uint8_t CHIRP_VERSION_2 = '\x02';
+
+/** Length of the header of a CHIRP v2 message in bytes, including the number of services */
+constexpr std::size_t CHIRP_V2_HEADER_LENGTH = 40;
+
+/** Length of a service entry in a CHIRP v2 message in bytes */
+constexpr std::size_t CHIRP_V2_SERVICE_LENGTH = 3;
+
+/** Maximum number of services in a CHIRP v2 message */
+constexpr std::size_t CHIRP_V2_MAX_SERVICES = 64;
+
+/** Maximum CHIRP v2 message length in bytes */
+constexpr std::size_t CHIRP_V2_MAX_MESSAGE_LENGTH = CHIRP_V2_HEADER_LENGTH + CHIRP_V2_MAX_SERVICES * CHIRP_V2_SERVICE_LENGTH;
+
 /** CHIRP message type */
 enum class MessageType : std::uint8_t {
     /** A message with REQUEST type indicates that CHIRP hosts should reply with an OFFER */
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "CHIRP/BroadcastRecv.hpp"
+#include "CHIRP/BroadcastSend.hpp"
+#include "CHIRP/Message.hpp"
+
+using namespace cnstln::CHIRP;
+using namespace std::literals::chrono_literals;
+
+// Number of packets queued per burst, small enough to fit in the default socket receive buffer
+constexpr std::size_t BURST_SIZE = 128;
+constexpr std::size_t BURST_COUNT = 1000;
+constexpr std::size_t BATCH_SIZE = 64;
+
+// Queue bursts of CHIRP messages and time how fast the receive function drains them, returns packets per second
+template <typename RecvFunction>
+double bench_recv(const char* name, RecvFunction recv_function) {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+    const auto asm_msg = Message(OFFER, "group1", "sat1", CONTROL, 23999).Assemble();
+
+    std::size_t received = 0;
+    std::chrono::steady_clock::duration recv_time {};
+    for (std::size_t burst = 0; burst < BURST_COUNT; ++burst) {
+        // Simulate a burst of OFFERs arriving while the receiver is busy
+        for (std::size_t n = 0; n < BURST_SIZE; ++n) {
+            sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        }
+        // Drain socket until timeout
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t burst_received = 0;
+        while (burst_received < BURST_SIZE) {
+            const auto ret = recv_function(receiver);
+            if (ret == 0) {
+                break;
+            }
+            burst_received += ret;
+        }
+        recv_time += std::chrono::steady_clock::now() - start;
+        received += burst_received;
+    }
+
+    const auto pps = static_cast<double>(received) / std::chrono::duration<double>(recv_time).count();
+    std::cout << std::left << std::setw(24) << name
+              << " received " << std::setw(10) << received
+              << " packets/s " << std::fixed << std::setprecision(0) << pps
+              << std::endl;
+    return pps;
+}
+
+int main() {
+    const auto pps_single = bench_recv("AsyncRecvBroadcast", [](BroadcastRecv& receiver) -> std::size_t {
+        return receiver.AsyncRecvBroadcast(10ms).has_value() ? 1 : 0;
+    });
+
+    std::vector<BroadcastMessage> msgs(BATCH_SIZE);
+    const auto pps_batch = bench_recv("AsyncRecvBroadcasts", [&msgs](BroadcastRecv& receiver) {
+        return receiver.AsyncRecvBroadcasts(msgs, 10ms);
+    });
+
+    std::cout << "\nBatched receive speedup: " << std::setprecision(2) << pps_batch / pps_single << "x" << std::endl;
+    return 0;
+}
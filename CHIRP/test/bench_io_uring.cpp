@@ -0,0 +1,183 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "CHIRP/BroadcastRecv.hpp"
+#include "CHIRP/BroadcastSend.hpp"
+#include "CHIRP/Message.hpp"
+
+using namespace cnstln::CHIRP;
+using namespace std::literals::chrono_literals;
+
+// Number of packets queued per burst, small enough to fit in the default socket receive buffer
+constexpr std::size_t BURST_SIZE = 128;
+constexpr std::size_t BURST_COUNT = 1000;
+constexpr std::size_t BATCH_SIZE = 64;
+
+// Number of packets sent one by one to measure latency
+constexpr std::size_t PING_COUNT = 10000;
+
+// Queue bursts of CHIRP messages, drain them and report system calls and time per packet
+void bench_burst(const char* name, BroadcastRecv& receiver) {
+    BroadcastSend sender {"0.0.0.0"};
+    const auto asm_msg = Message(OFFER, "group1", "sat1", CONTROL, 23999).Assemble();
+
+    std::array<std::array<std::uint8_t, CHIRP_MESSAGE_LENGTH>, BATCH_SIZE> storage {};
+    std::array<BroadcastBuffer, BATCH_SIZE> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+
+    const auto syscalls_start = receiver.GetStats().syscalls;
+    std::size_t received = 0;
+    std::chrono::steady_clock::duration recv_time {};
+    for (std::size_t burst = 0; burst < BURST_COUNT; ++burst) {
+        for (std::size_t n = 0; n < BURST_SIZE; ++n) {
+            sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        }
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t burst_received = 0;
+        while (burst_received < BURST_SIZE) {
+            const auto ret = receiver.AsyncRecvBroadcasts(buffers, 10ms);
+            if (ret == 0) {
+                break;
+            }
+            burst_received += ret;
+        }
+        recv_time += std::chrono::steady_clock::now() - start;
+        received += burst_received;
+    }
+    const auto syscalls = receiver.GetStats().syscalls - syscalls_start;
+
+    const auto ns_per_packet = std::chrono::duration<double, std::nano>(recv_time).count() / static_cast<double>(received);
+    std::cout << std::left << std::setw(24) << name
+              << " burst:   syscalls/packet " << std::fixed << std::setprecision(3)
+              << static_cast<double>(syscalls) / static_cast<double>(received)
+              << "  ns/packet " << std::setprecision(0) << ns_per_packet
+              << std::endl;
+}
+
+// Send packets one by one and report mean time until each packet is received
+void bench_ping(const char* name, BroadcastRecv& receiver) {
+    BroadcastSend sender {"0.0.0.0"};
+    const auto asm_msg = Message(OFFER, "group1", "sat1", CONTROL, 23999).Assemble();
+
+    std::array<std::uint8_t, CHIRP_MESSAGE_LENGTH> storage {};
+    std::array<BroadcastBuffer, 1> buffers {};
+    buffers[0].buffer = storage;
+
+    const auto syscalls_start = receiver.GetStats().syscalls;
+    std::size_t received = 0;
+    std::chrono::steady_clock::duration latency {};
+    for (std::size_t n = 0; n < PING_COUNT; ++n) {
+        const auto start = std::chrono::steady_clock::now();
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        received += receiver.AsyncRecvBroadcasts(buffers, 10ms);
+        latency += std::chrono::steady_clock::now() - start;
+    }
+    const auto syscalls = receiver.GetStats().syscalls - syscalls_start;
+
+    const auto ns_per_packet = std::chrono::duration<double, std::nano>(latency).count() / static_cast<double>(received);
+    std::cout << std::left << std::setw(24) << name
+              << " ping:    syscalls/packet " << std::fixed << std::setprecision(3)
+              << static_cast<double>(syscalls) / static_cast<double>(received)
+              << "  ns/packet " << std::setprecision(0) << ns_per_packet
+              << std::endl;
+}
+
+// Drain all queued packets without measuring
+void drain(BroadcastRecv& receiver) {
+    std::array<std::array<std::uint8_t, CHIRP_MESSAGE_LENGTH>, BATCH_SIZE> storage {};
+    std::array<BroadcastBuffer, BATCH_SIZE> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+    while (receiver.AsyncRecvBroadcasts(buffers, 1ms) > 0) {
+    }
+}
+
+// Send bursts of CHIRP messages in batches and report system calls and time per packet
+void bench_send_burst(const char* name, BroadcastSend& sender) {
+    BroadcastRecv receiver {"0.0.0.0"};
+    const auto asm_msg = Message(OFFER, "group1", "sat1", CONTROL, 23999).Assemble();
+    const std::vector<asio::const_buffer> messages(BURST_SIZE, asio::buffer(asm_msg.data(), asm_msg.size()));
+
+    const auto syscalls_start = sender.GetSyscalls();
+    std::chrono::steady_clock::duration send_time {};
+    for (std::size_t burst = 0; burst < BURST_COUNT; ++burst) {
+        const auto start = std::chrono::steady_clock::now();
+        sender.SendBroadcasts(messages);
+        send_time += std::chrono::steady_clock::now() - start;
+        drain(receiver);
+    }
+    const auto syscalls = sender.GetSyscalls() - syscalls_start;
+
+    const auto packets = static_cast<double>(BURST_SIZE * BURST_COUNT);
+    std::cout << std::left << std::setw(24) << name
+              << " burst:   syscalls/packet " << std::fixed << std::setprecision(3)
+              << static_cast<double>(syscalls) / packets
+              << "  ns/packet " << std::setprecision(0) << std::chrono::duration<double, std::nano>(send_time).count() / packets
+              << std::endl;
+}
+
+// Send packets one by one and report mean time until each send returns
+void bench_send_single(const char* name, BroadcastSend& sender) {
+    BroadcastRecv receiver {"0.0.0.0"};
+    const auto asm_msg = Message(OFFER, "group1", "sat1", CONTROL, 23999).Assemble();
+
+    const auto syscalls_start = sender.GetSyscalls();
+    std::chrono::steady_clock::duration latency {};
+    for (std::size_t n = 0; n < PING_COUNT; ++n) {
+        const auto start = std::chrono::steady_clock::now();
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        latency += std::chrono::steady_clock::now() - start;
+        if (n % BURST_SIZE == BURST_SIZE - 1) {
+            drain(receiver);
+        }
+    }
+    const auto syscalls = sender.GetSyscalls() - syscalls_start;
+
+    const auto packets = static_cast<double>(PING_COUNT);
+    std::cout << std::left << std::setw(24) << name
+              << " single:  syscalls/packet " << std::fixed << std::setprecision(3)
+              << static_cast<double>(syscalls) / packets
+              << "  ns/packet " << std::setprecision(0) << std::chrono::duration<double, std::nano>(latency).count() / packets
+              << std::endl;
+}
+
+int main() {
+    {
+        BroadcastRecv receiver {"0.0.0.0"};
+        bench_burst("epoll", receiver);
+        bench_ping("epoll", receiver);
+    }
+
+    {
+        BroadcastSend sender {"0.0.0.0"};
+        bench_send_burst("sendmmsg", sender);
+        bench_send_single("send", sender);
+    }
+
+    BroadcastRecv receiver {"0.0.0.0"};
+    if (!receiver.EnableIoUring()) {
+        std::cout << "io_uring not supported on this platform or build" << std::endl;
+        return 0;
+    }
+    bench_burst("io_uring", receiver);
+    bench_ping("io_uring", receiver);
+
+    BroadcastSend sender {"0.0.0.0"};
+    if (!sender.EnableIoUring()) {
+        std::cout << "io_uring send not supported on this platform or build" << std::endl;
+        return 0;
+    }
+    bench_send_burst("io_uring send", sender);
+    bench_send_single("io_uring send", sender);
+    return 0;
+}
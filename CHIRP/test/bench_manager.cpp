@@ -0,0 +1,342 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "CHIRP/BroadcastSend.hpp"
+#include "CHIRP/Manager.hpp"
+#include "CHIRP/Message.hpp"
+
+using namespace cnstln::CHIRP;
+using namespace std::literals::chrono_literals;
+
+constexpr std::size_t HOST_COUNT = 4096;
+constexpr std::size_t BURST_SIZE = 64;
+constexpr auto BENCH_TIMEOUT = 2s;
+constexpr auto STEADY_DURATION = 100ms;
+
+// Assemble OFFERs from many simulated hosts
+std::vector<AssembledMessage> assemble_offers() {
+    std::vector<AssembledMessage> asm_msgs {};
+    asm_msgs.reserve(HOST_COUNT);
+    for (std::size_t n = 0; n < HOST_COUNT; ++n) {
+        asm_msgs.push_back(Message(OFFER, "bench", "sat" + std::to_string(n), CONTROL, 23999).Assemble());
+    }
+    return asm_msgs;
+}
+
+// Broadcast all OFFERs over loopback and time until all services are discovered
+void bench_recv_threads(std::size_t recv_threads, const std::vector<AssembledMessage>& asm_msgs) {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "bench", "manager"};
+    manager.Start(recv_threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < asm_msgs.size(); ++n) {
+        sender.SendBroadcast(asm_msgs[n].data(), asm_msgs[n].size());
+        // Give receive threads a chance to drain their sockets between bursts
+        if (n % BURST_SIZE == BURST_SIZE - 1) {
+            std::this_thread::yield();
+        }
+    }
+    std::size_t discovered = 0;
+    while (std::chrono::steady_clock::now() - start < BENCH_TIMEOUT) {
+        discovered = manager.GetDiscoveredServices().size();
+        if (discovered == asm_msgs.size()) {
+            break;
+        }
+        std::this_thread::sleep_for(100us);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "recv threads " << std::setw(2) << recv_threads
+              << " discovered " << std::setw(5) << discovered << "/" << asm_msgs.size()
+              << " time " << std::fixed << std::setprecision(2) << std::setw(7) << elapsed * 1e3 << " ms"
+              << " OFFERs/s " << std::setprecision(0) << static_cast<double>(discovered) / elapsed
+              << std::endl;
+}
+
+// Broadcast all OFFERs while reader threads poll the discovered services, either from snapshots or by copying them
+// while holding the lock, and report discovery time as well as reads per second during and after discovery
+void bench_snapshot_readers(std::size_t reader_threads, bool snapshot, const std::vector<AssembledMessage>& asm_msgs) {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "bench", "manager"};
+    manager.Start();
+
+    std::atomic_bool stop {false};
+    std::atomic_uint64_t reads {0};
+    std::vector<std::thread> readers {};
+    readers.reserve(reader_threads);
+    for (std::size_t n = 0; n < reader_threads; ++n) {
+        readers.emplace_back([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (snapshot) {
+                    manager.GetDiscoveredServicesSnapshot();
+                }
+                else {
+                    manager.GetDiscoveredServices(CONTROL);
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+                // Do not starve the receive thread on machines with few cores
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < asm_msgs.size(); ++n) {
+        sender.SendBroadcast(asm_msgs[n].data(), asm_msgs[n].size());
+        if (n % BURST_SIZE == BURST_SIZE - 1) {
+            std::this_thread::yield();
+        }
+    }
+    std::size_t discovered = 0;
+    while (std::chrono::steady_clock::now() - start < BENCH_TIMEOUT) {
+        discovered = manager.GetDiscoveredServicesSnapshot()->size();
+        if (discovered == asm_msgs.size()) {
+            break;
+        }
+        std::this_thread::sleep_for(100us);
+    }
+    const auto discovery_end = std::chrono::steady_clock::now();
+    const auto discovery_reads = reads.exchange(0);
+
+    // Keep reading without changes to the discovered services
+    std::this_thread::sleep_for(STEADY_DURATION);
+    const auto steady_end = std::chrono::steady_clock::now();
+    const auto steady_reads = reads.load();
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    const auto elapsed = std::chrono::duration<double>(discovery_end - start).count();
+    const auto steady_elapsed = std::chrono::duration<double>(steady_end - discovery_end).count();
+    std::cout << (snapshot ? "snapshot" : "locked  ") << " readers " << std::setw(2) << reader_threads
+              << " discovered " << std::setw(5) << discovered << "/" << asm_msgs.size()
+              << " time " << std::fixed << std::setprecision(2) << std::setw(7) << elapsed * 1e3 << " ms"
+              << " reads/s " << std::setprecision(0) << std::setw(8) << static_cast<double>(discovery_reads) / elapsed
+              << " steady reads/s " << std::setw(8) << static_cast<double>(steady_reads) / steady_elapsed
+              << std::endl;
+}
+
+constexpr std::size_t CALLBACK_COUNT = 2000;
+constexpr auto CALLBACK_WORK = 10us;
+
+// Callback state tracking the number of concurrently running callbacks
+struct CallbackState {
+    std::atomic_size_t active {0};
+    std::atomic_size_t peak {0};
+    std::atomic_size_t done {0};
+    std::atomic_int64_t latency_total {0};
+    std::atomic_int64_t latency_max {0};
+};
+
+void callback_work(CallbackState& state) {
+    const auto active = ++state.active;
+    auto peak = state.peak.load();
+    while (active > peak && !state.peak.compare_exchange_weak(peak, active)) {
+    }
+    // Busy work such as updating a connection table
+    const auto work_end = std::chrono::steady_clock::now() + CALLBACK_WORK;
+    while (std::chrono::steady_clock::now() < work_end) {
+    }
+    --state.active;
+    ++state.done;
+}
+
+void print_callbacks(const char* name, std::size_t threads, const CallbackState& state, double elapsed, double latency_mean, double latency_max) {
+    std::cout << name << " threads " << std::setw(4) << threads
+              << " callbacks " << std::setw(4) << state.done.load() << "/" << CALLBACK_COUNT
+              << " time " << std::fixed << std::setprecision(2) << std::setw(7) << elapsed * 1e3 << " ms"
+              << " peak concurrent " << std::setw(4) << state.peak.load()
+              << " latency mean " << std::setw(8) << latency_mean << " us max " << std::setw(8) << latency_max << " us"
+              << std::endl;
+}
+
+// Start a detached thread per callback, as done before callbacks were queued to callback threads
+void bench_callbacks_detached() {
+    CallbackState state {};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < CALLBACK_COUNT; ++n) {
+        std::thread([&state, handle_time = std::chrono::steady_clock::now()]() {
+            const auto latency = (std::chrono::steady_clock::now() - handle_time) / 1ns;
+            state.latency_total += latency;
+            auto latency_max = state.latency_max.load();
+            while (latency > latency_max && !state.latency_max.compare_exchange_weak(latency_max, latency)) {
+            }
+            callback_work(state);
+        }).detach();
+    }
+    while (state.done.load() < CALLBACK_COUNT) {
+        std::this_thread::sleep_for(100us);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print_callbacks("detached", CALLBACK_COUNT, state, elapsed,
+                    static_cast<double>(state.latency_total.load()) / CALLBACK_COUNT / 1e3,
+                    static_cast<double>(state.latency_max.load()) / 1e3);
+}
+
+// Broadcast OFFERs for a registered callback and time until all callbacks finished on the callback threads
+void bench_callbacks_threads(std::size_t callback_threads, const std::vector<AssembledMessage>& asm_msgs) {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "bench", "manager"};
+    manager.SetCallbackThreads(callback_threads);
+    CallbackState state {};
+    manager.RegisterDiscoverCallback(
+        [](DiscoveredService /*service*/, bool /*depart*/, std::any user_data) {
+            callback_work(*std::any_cast<CallbackState*>(user_data));
+        },
+        CONTROL, &state);
+    manager.Start();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < CALLBACK_COUNT; ++n) {
+        sender.SendBroadcast(asm_msgs[n].data(), asm_msgs[n].size());
+        if (n % BURST_SIZE == BURST_SIZE - 1) {
+            std::this_thread::yield();
+        }
+    }
+    while (state.done.load() < CALLBACK_COUNT && std::chrono::steady_clock::now() - start < BENCH_TIMEOUT) {
+        std::this_thread::sleep_for(100us);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto stats = manager.GetLatencyStats().dispatch;
+    print_callbacks("pool    ", callback_threads, state, elapsed,
+                    std::chrono::duration<double, std::micro>(stats.mean()).count(),
+                    std::chrono::duration<double, std::micro>(stats.max).count());
+}
+
+constexpr auto BATCH_WINDOW = 10ms;
+constexpr std::size_t BATCH_MAX_EVENTS = 256;
+
+// Callback state counting delivered events and invocations
+struct BatchState {
+    std::atomic_size_t events {0};
+    std::atomic_size_t invocations {0};
+};
+
+// Busy work per invocation such as rebuilding a connection table
+void rebuild_work(BatchState& state, std::size_t events) {
+    const auto work_end = std::chrono::steady_clock::now() + CALLBACK_WORK;
+    while (std::chrono::steady_clock::now() < work_end) {
+    }
+    ++state.invocations;
+    state.events += events;
+}
+
+// Broadcast OFFERs and time until all events were delivered, either to a callback per event or to a batch callback
+void bench_batch_callbacks(bool batch, const std::vector<AssembledMessage>& asm_msgs) {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "bench", "manager"};
+    BatchState state {};
+    if (batch) {
+        manager.RegisterDiscoverBatchCallback(
+            [](std::span<const DiscoverEvent> events, std::any user_data) {
+                rebuild_work(*std::any_cast<BatchState*>(user_data), events.size());
+            },
+            CONTROL, &state, BATCH_WINDOW, BATCH_MAX_EVENTS);
+    }
+    else {
+        manager.RegisterDiscoverCallback(
+            [](DiscoveredService /*service*/, bool /*depart*/, std::any user_data) {
+                rebuild_work(*std::any_cast<BatchState*>(user_data), 1);
+            },
+            CONTROL, &state);
+    }
+    manager.Start();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < CALLBACK_COUNT; ++n) {
+        sender.SendBroadcast(asm_msgs[n].data(), asm_msgs[n].size());
+        if (n % BURST_SIZE == BURST_SIZE - 1) {
+            std::this_thread::yield();
+        }
+    }
+    while (state.events.load() < CALLBACK_COUNT && std::chrono::steady_clock::now() - start < BENCH_TIMEOUT) {
+        std::this_thread::sleep_for(100us);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto stats = manager.GetLatencyStats().dispatch;
+
+    std::cout << (batch ? "batch callback" : "callback      ")
+              << " events " << std::setw(4) << state.events.load() << "/" << CALLBACK_COUNT
+              << " invocations " << std::setw(4) << state.invocations.load()
+              << " time " << std::fixed << std::setprecision(2) << std::setw(7) << elapsed * 1e3 << " ms"
+              << " latency mean " << std::setw(8) << std::chrono::duration<double, std::micro>(stats.mean()).count() << " us"
+              << std::endl;
+}
+
+constexpr std::size_t REPLY_SERVICES = 64;
+constexpr std::size_t REPLY_ROUNDS = 100000;
+
+// Compare assembling OFFERs for every REQUEST to copying OFFERs assembled on registration
+void bench_offer_replay() {
+    const MD5Hash group_id {"bench"};
+    const MD5Hash host_id {"manager"};
+    std::array<AssembledMessage, REPLY_SERVICES> cached {};
+    for (std::size_t n = 0; n < REPLY_SERVICES; ++n) {
+        cached[n] = Message(OFFER, group_id, host_id, CONTROL, static_cast<Port>(23000 + n)).Assemble();
+    }
+
+    std::array<AssembledMessage, REPLY_SERVICES> out {};
+    std::uint8_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < REPLY_ROUNDS; ++round) {
+        for (std::size_t n = 0; n < REPLY_SERVICES; ++n) {
+            out[n] = Message(OFFER, group_id, host_id, CONTROL, static_cast<Port>(23000 + n)).Assemble();
+        }
+        checksum ^= out[round % REPLY_SERVICES][40];
+    }
+    const auto assemble_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < REPLY_ROUNDS; ++round) {
+        for (std::size_t n = 0; n < REPLY_SERVICES; ++n) {
+            out[n] = cached[n];
+        }
+        checksum ^= out[round % REPLY_SERVICES][40];
+    }
+    const auto cached_time = std::chrono::steady_clock::now() - start;
+
+    const auto messages = static_cast<double>(REPLY_ROUNDS * REPLY_SERVICES);
+    std::cout << "OFFER replay assembled ns/message " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double, std::nano>(assemble_time).count() / messages
+              << " cached ns/message "
+              << std::chrono::duration<double, std::nano>(cached_time).count() / messages
+              << " (checksum " << static_cast<int>(checksum) << ")" << std::endl;
+}
+
+int main() {
+    const auto asm_msgs = assemble_offers();
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << "\n" << std::endl;
+    for (const std::size_t recv_threads : {1, 2, 4, 8}) {
+        bench_recv_threads(recv_threads, asm_msgs);
+    }
+    std::cout << std::endl;
+    for (const std::size_t reader_threads : {0, 1, 4, 8}) {
+        bench_snapshot_readers(reader_threads, false, asm_msgs);
+        bench_snapshot_readers(reader_threads, true, asm_msgs);
+    }
+    std::cout << std::endl;
+    bench_callbacks_detached();
+    for (const std::size_t callback_threads : {1, 4, 8}) {
+        bench_callbacks_threads(callback_threads, asm_msgs);
+    }
+    std::cout << std::endl;
+    bench_batch_callbacks(false, asm_msgs);
+    bench_batch_callbacks(true, asm_msgs);
+    std::cout << std::endl;
+    bench_offer_replay();
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
+#include "CHIRP/exceptions.hpp"
+#include "CHIRP/Message.hpp"
+
+using namespace cnstln::CHIRP;
+
+constexpr std::size_t MESSAGE_COUNT = 1000000;
+
+// Mixed traffic on a shared port: valid CHIRP messages, wrong CHIRP version, unknown type and foreign protocol
+std::array<AssembledMessage, 4> assemble_traffic() {
+    std::array<AssembledMessage, 4> traffic {};
+    traffic[0] = Message(OFFER, "bench", "sat1", CONTROL, 23999).Assemble();
+    traffic[1] = traffic[0];
+    traffic[1][5] = CHIRP_VERSION + 1;
+    traffic[2] = traffic[0];
+    traffic[2][6] = 255;
+    traffic[3].fill('x');
+    return traffic;
+}
+
+// Decode mixed traffic and report time per message and number of valid messages
+template <typename Decoder>
+void bench_decode(const char* name, const std::array<AssembledMessage, 4>& traffic, Decoder decoder) {
+    std::size_t valid = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < MESSAGE_COUNT; ++n) {
+        valid += decoder(traffic[n % traffic.size()]) ? 1 : 0;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto ns_per_message = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(MESSAGE_COUNT);
+    std::cout << std::left << std::setw(24) << name
+              << " valid " << valid << "/" << MESSAGE_COUNT
+              << "  ns/message " << std::fixed << std::setprecision(1) << ns_per_message
+              << "  messages/s " << std::setprecision(0) << 1e9 / ns_per_message
+              << std::endl;
+}
+
+int main() {
+    const auto traffic = assemble_traffic();
+
+    bench_decode("Message (exceptions)", traffic, [](const AssembledMessage& asm_msg) {
+        try {
+            const Message msg {asm_msg};
+            return msg.GetPort() != 0;
+        }
+        catch (const DecodeError&) {
+            return false;
+        }
+    });
+    bench_decode("Message::TryDecode", traffic, [](const AssembledMessage& asm_msg) {
+        const auto result = Message::TryDecode(asm_msg);
+        return result && result->GetPort() != 0;
+    });
+    bench_decode("MessageView", traffic, [](const AssembledMessage& asm_msg) {
+        const MessageView view {asm_msg};
+        return view.IsValid() && view.GetPort() != 0;
+    });
+    return 0;
+}
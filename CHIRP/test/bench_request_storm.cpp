@@ -0,0 +1,91 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CHIRP/Manager.hpp"
+
+using namespace cnstln::CHIRP;
+using namespace std::literals::chrono_literals;
+
+constexpr std::size_t HOST_COUNT = 128;
+constexpr auto BENCH_TIMEOUT = 5s;
+
+constexpr std::array<ServiceIdentifier, 4> SERVICE_IDS {CONTROL, HEARTBEAT, MONITORING, DATA};
+
+// Start many simulated hosts in quick succession, each registering services and sending a REQUEST for each of them, and
+// report the time until all hosts discovered all services of all other hosts as well as the number of broadcasts sent
+void bench_request_storm(std::chrono::milliseconds jitter, std::chrono::milliseconds hold_off, std::size_t service_count, bool protocol_v2) {
+    std::vector<std::unique_ptr<Manager>> managers {};
+    managers.reserve(HOST_COUNT);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < HOST_COUNT; ++n) {
+        auto& manager = managers.emplace_back(
+            std::make_unique<Manager>("127.255.255.255", "0.0.0.0", "bench", "sat" + std::to_string(n)));
+        manager->SetReplyJitter(jitter);
+        manager->SetReplyHoldOff(hold_off);
+        if (protocol_v2) {
+            manager->EnableProtocolV2();
+        }
+        std::vector<RegisteredService> services {};
+        for (std::size_t s = 0; s < service_count; ++s) {
+            services.push_back({SERVICE_IDS[s], static_cast<Port>(23000 + n)});
+        }
+        manager->RegisterServices(services);
+        manager->Start();
+        for (std::size_t s = 0; s < service_count; ++s) {
+            manager->SendRequest(SERVICE_IDS[s]);
+        }
+    }
+
+    std::size_t converged = 0;
+    while (std::chrono::steady_clock::now() - start < BENCH_TIMEOUT) {
+        converged = 0;
+        for (auto& manager : managers) {
+            converged += manager->GetDiscoveredServices().size() == service_count * (HOST_COUNT - 1) ? 1 : 0;
+        }
+        if (converged == HOST_COUNT) {
+            break;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t broadcasts = 0;
+    std::uint64_t coalesced = 0;
+    std::uint64_t suppressed = 0;
+    for (auto& manager : managers) {
+        broadcasts += manager->GetSendStats().queued;
+        const auto stats = manager->GetReplyStats();
+        coalesced += stats.coalesced;
+        suppressed += stats.suppressed;
+    }
+
+    std::cout << "services " << service_count << (protocol_v2 ? " v2" : " v1")
+              << " jitter " << std::setw(3) << jitter.count() << " ms"
+              << " hold-off " << std::setw(3) << hold_off.count() << " ms"
+              << " converged " << std::setw(3) << converged << "/" << HOST_COUNT
+              << " time " << std::fixed << std::setprecision(2) << std::setw(8) << elapsed * 1e3 << " ms"
+              << " broadcasts " << std::setw(6) << broadcasts
+              << " coalesced " << std::setw(6) << coalesced
+              << " suppressed " << std::setw(6) << suppressed
+              << std::endl;
+}
+
+int main() {
+    bench_request_storm(0ms, 0ms, 1, false);
+    bench_request_storm(10ms, 0ms, 1, false);
+    bench_request_storm(50ms, 0ms, 1, false);
+    bench_request_storm(50ms, 10ms, 1, false);
+    // Hosts offering all services, packed into CHIRP v2 messages once negotiated
+    bench_request_storm(50ms, 10ms, 4, false);
+    bench_request_storm(50ms, 10ms, 4, true);
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "asio.hpp"
+
+#include "CHIRP/Manager.hpp"
+#include "CHIRP/Message.hpp"
+
+using namespace cnstln::CHIRP;
+
+constexpr std::size_t HOST_COUNT = 2500;
+constexpr std::array<ServiceIdentifier, 4> SERVICE_IDS {CONTROL, HEARTBEAT, MONITORING, DATA};
+constexpr std::size_t HASH_COUNT = 256;
+constexpr std::size_t COMPARE_COUNT = 10000000;
+constexpr std::size_t LOOKUP_ROUNDS = 16;
+constexpr std::size_t POLL_ROUNDS = 1000;
+constexpr std::size_t POLL_CHANGES = 8;
+constexpr std::size_t REFRESH_ROUNDS = 16;
+constexpr std::uint64_t SERVICE_TTL = 10000;
+
+// Services of many simulated hosts
+std::vector<DiscoveredService> discover_services() {
+    const auto address = asio::ip::make_address("127.0.0.1");
+    std::vector<DiscoveredService> services {};
+    services.reserve(HOST_COUNT * SERVICE_IDS.size());
+    for (std::size_t n = 0; n < HOST_COUNT; ++n) {
+        for (const auto service_id : SERVICE_IDS) {
+            services.push_back({address, MD5Hash("sat" + std::to_string(n)), service_id, 23999});
+        }
+    }
+    return services;
+}
+
+void print_result(const char* name, std::chrono::steady_clock::duration elapsed, std::size_t count, std::size_t result) {
+    const auto ns_per_op = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(count);
+    std::cout << std::left << std::setw(40) << name
+              << " ns/op " << std::right << std::fixed << std::setprecision(2) << std::setw(7) << ns_per_op
+              << "  result " << result
+              << std::endl;
+}
+
+// Compare pairs of host IDs sharing a prefix, as byte-wise comparison has to look past the first bytes
+template <typename Compare>
+void bench_compare(const char* name, const std::vector<MD5Hash>& hashes, Compare compare) {
+    std::size_t smaller = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < COMPARE_COUNT; ++n) {
+        smaller += compare(hashes[n % HASH_COUNT], hashes[(n + 1) % HASH_COUNT]) ? 1 : 0;
+    }
+    print_result(name, std::chrono::steady_clock::now() - start, COMPARE_COUNT, smaller);
+}
+
+// Insert all services, look each of them up several times and list the services of one service identifier
+template <typename Container, typename Insert, typename Contains, typename Filter>
+void bench_lookup(const std::string& name, const std::vector<DiscoveredService>& services, Insert insert, Contains contains, Filter filter) {
+    Container container {};
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& service : services) {
+        insert(container, service);
+    }
+    print_result((name + " insert").c_str(), std::chrono::steady_clock::now() - start, services.size(), services.size());
+
+    std::size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < LOOKUP_ROUNDS; ++round) {
+        for (const auto& service : services) {
+            found += contains(container, service) ? 1 : 0;
+        }
+    }
+    print_result((name + " lookup").c_str(), std::chrono::steady_clock::now() - start, services.size() * LOOKUP_ROUNDS, found);
+
+    found = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < LOOKUP_ROUNDS; ++round) {
+        found += filter(container, SERVICE_IDS[round % SERVICE_IDS.size()]).size();
+    }
+    print_result((name + " filter").c_str(), std::chrono::steady_clock::now() - start, LOOKUP_ROUNDS, found);
+}
+
+// Services with a given service identifier from a standard container
+template <typename Container>
+std::vector<DiscoveredService> filter_services(const Container& container, ServiceIdentifier service_id) {
+    std::vector<DiscoveredService> ret {};
+    for (const auto& service : container) {
+        if (service.identifier == service_id) {
+            ret.push_back(service);
+        }
+    }
+    return ret;
+}
+
+// Keep track of all services while a few of them depart and return between polls, either by copying and diffing all
+// services or by requesting the changes since the last poll
+void bench_poll(const std::vector<DiscoveredService>& services) {
+    DiscoveredServiceTable table {};
+    for (const auto& service : services) {
+        table.Insert(service);
+    }
+    const auto change_services = [&](std::size_t round) {
+        for (std::size_t n = 0; n < POLL_CHANGES / 2; ++n) {
+            const auto& service = services[(round * POLL_CHANGES + n) % services.size()];
+            table.Erase(service);
+            table.Insert(service);
+        }
+    };
+
+    std::unordered_set<DiscoveredService> tracked {services.begin(), services.end()};
+    std::size_t diffs = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < POLL_ROUNDS; ++round) {
+        change_services(round);
+        const auto current = table.GetServices();
+        std::unordered_set<DiscoveredService> current_set {current.begin(), current.end()};
+        diffs += std::ranges::count_if(current, [&](const auto& service) { return !tracked.contains(service); });
+        tracked = std::move(current_set);
+    }
+    print_result("poll copy and diff", std::chrono::steady_clock::now() - start, POLL_ROUNDS, diffs);
+
+    std::uint64_t generation = table.GetGeneration();
+    std::size_t changes = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < POLL_ROUNDS; ++round) {
+        change_services(round);
+        const auto result = table.GetChanges(generation);
+        for (const auto& change : result.changes) {
+            if (change.depart) {
+                tracked.erase(change.service);
+            }
+            else {
+                tracked.insert(change.service);
+            }
+        }
+        changes += result.changes.size();
+        generation = result.generation;
+    }
+    print_result("poll changes", std::chrono::steady_clock::now() - start, POLL_ROUNDS, changes);
+}
+
+// Refresh the expiry of all services several times with spread out ticks, then let all of them expire
+void bench_expiry(std::size_t host_count) {
+    const auto address = asio::ip::make_address("127.0.0.1");
+    std::vector<DiscoveredService> services {};
+    services.reserve(host_count * SERVICE_IDS.size());
+    for (std::size_t n = 0; n < host_count; ++n) {
+        for (const auto service_id : SERVICE_IDS) {
+            services.push_back({address, MD5Hash("sat" + std::to_string(n)), service_id, 23999});
+        }
+    }
+
+    DiscoveredServiceTable table {};
+    std::vector<DiscoveredService> expired {};
+    std::uint64_t tick = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < REFRESH_ROUNDS; ++round) {
+        for (std::size_t n = 0; n < services.size(); ++n) {
+            // Spread refreshes over the time to live as OFFERs arrive over time
+            tick = round * SERVICE_TTL / 2 + n * SERVICE_TTL / 2 / services.size();
+            table.Refresh(services[n], tick + SERVICE_TTL);
+        }
+        table.Expire(tick, expired);
+    }
+    const auto refresh_time = std::chrono::steady_clock::now() - start;
+    const auto refreshed = table.Size();
+
+    start = std::chrono::steady_clock::now();
+    table.Expire(tick + 2 * SERVICE_TTL, expired);
+    const auto expire_time = std::chrono::steady_clock::now() - start;
+
+    const auto name = std::to_string(services.size()) + " services";
+    print_result(("refresh " + name).c_str(), refresh_time, REFRESH_ROUNDS * services.size(), refreshed);
+    print_result(("expire " + name).c_str(), expire_time, services.size(), expired.size());
+}
+
+int main() {
+    std::vector<MD5Hash> hashes {};
+    for (std::size_t n = 0; n < HASH_COUNT; ++n) {
+        auto hash = MD5Hash("sat" + std::to_string(n));
+        std::fill_n(hash.begin(), 6, 0);
+        hashes.push_back(hash);
+    }
+    bench_compare("MD5Hash byte-wise compare", hashes, [](const MD5Hash& a, const MD5Hash& b) {
+        return std::ranges::lexicographical_compare(a, b);
+    });
+    bench_compare("MD5Hash::operator<", hashes, [](const MD5Hash& a, const MD5Hash& b) { return a < b; });
+
+    const auto services = discover_services();
+    const auto insert = [](auto& container, const DiscoveredService& service) { container.insert(service); };
+    const auto contains = [](const auto& container, const DiscoveredService& service) { return container.contains(service); };
+    bench_lookup<std::set<DiscoveredService>>("std::set", services, insert, contains,
+                                              filter_services<std::set<DiscoveredService>>);
+    bench_lookup<std::unordered_set<DiscoveredService>>("std::unordered_set", services, insert, contains,
+                                                        filter_services<std::unordered_set<DiscoveredService>>);
+    bench_lookup<DiscoveredServiceTable>(
+        "DiscoveredServiceTable", services,
+        [](DiscoveredServiceTable& table, const DiscoveredService& service) { table.Insert(service); },
+        [](const DiscoveredServiceTable& table, const DiscoveredService& service) { return table.Contains(service); },
+        [](const DiscoveredServiceTable& table, ServiceIdentifier service_id) { return table.GetServices(service_id); });
+    bench_poll(services);
+    for (const std::size_t host_count : {250, 2500, 25000}) {
+        bench_expiry(host_count);
+    }
+    return 0;
+}
@@ -1,7 +1,10 @@
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <future>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "asio.hpp"
@@ -9,6 +12,10 @@
 #include "CHIRP/BroadcastSend.hpp"
 #include "CHIRP/BroadcastRecv.hpp"
 
+#ifdef __linux__
+#include <net/if.h>
+#endif
+
 using namespace cnstln::CHIRP;
 using namespace std::literals::chrono_literals;
 using namespace std::literals::string_literals;
@@ -87,6 +94,511 @@ int test_broadcast_async_recv_timeout() {
     return msg_opt.has_value() ? 1 : 0;
 }
 
+int test_broadcast_send_async_recv_batch() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    // Send messages before receiving such that they are queued in the socket
+    auto msg_content = "test message"s;
+    sender.SendBroadcast(msg_content + "1");
+    sender.SendBroadcast(msg_content + "2");
+    sender.SendBroadcast(msg_content + "3");
+    // Receive messages into storage larger than the number of queued messages
+    std::vector<BroadcastMessage> msgs(8);
+    auto received = receiver.AsyncRecvBroadcasts(msgs, 10ms);
+
+    int fails = 0;
+    // Check that all messages were received in one batch
+    fails += received == 3 ? 0 : 1;
+    fails += msgs[0].content_to_string() == msg_content + "1" ? 0 : 1;
+    fails += msgs[2].content_to_string() == msg_content + "3" ? 0 : 1;
+    // Check that batch is limited by the size of the storage
+    sender.SendBroadcast(msg_content);
+    sender.SendBroadcast(msg_content);
+    received = receiver.AsyncRecvBroadcasts(std::span(msgs).first(1), 10ms);
+    fails += received == 1 ? 0 : 1;
+    received = receiver.AsyncRecvBroadcasts(msgs, 10ms);
+    fails += received == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_async_recv_batch_timeout() {
+    BroadcastRecv receiver {"0.0.0.0"};
+
+    // Try receiving new messages
+    std::vector<BroadcastMessage> msgs(8);
+    auto received = receiver.AsyncRecvBroadcasts(msgs, 10ms);
+
+    // No message send, thus check for a timeout
+    return received == 0 ? 0 : 1;
+}
+
+int test_broadcast_async_recv_buffers() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    // Caller-provided storage with fixed size
+    std::array<std::array<std::uint8_t, 4>, 2> storage {};
+    std::array<BroadcastBuffer, 2> buffers {};
+    buffers[0].buffer = storage[0];
+    buffers[1].buffer = storage[1];
+
+    // Send oversized message between two fitting messages
+    sender.SendBroadcast("TEST"s);
+    sender.SendBroadcast("OVERSIZED"s);
+    sender.SendBroadcast("ABC"s);
+    auto received = receiver.AsyncRecvBroadcasts(buffers, 10ms);
+
+    int fails = 0;
+    // Check that oversized message was rejected
+    fails += received == 2 ? 0 : 1;
+    fails += buffers[0].length == 4 && storage[0] == std::array<std::uint8_t, 4>({'T', 'E', 'S', 'T'}) ? 0 : 1;
+    fails += buffers[1].length == 3 && storage[1][0] == 'A' && storage[1][2] == 'C' ? 0 : 1;
+    fails += buffers[1].address == asio::ip::make_address("127.0.0.1") ? 0 : 1;
+    fails += receiver.GetStats().oversized == 1 ? 0 : 1;
+
+    // Caller-provided storage with different sizes
+    std::array<std::uint8_t, 4> storage_medium {};
+    std::array<std::uint8_t, 8> storage_large {};
+    std::array<std::uint8_t, 2> storage_small {};
+    std::array<BroadcastBuffer, 3> mixed_buffers {};
+    mixed_buffers[0].buffer = storage_medium;
+    mixed_buffers[1].buffer = storage_large;
+    mixed_buffers[2].buffer = storage_small;
+
+    // Test that every message fitting the buffer it is stored in is delivered after an oversized message
+    sender.SendBroadcast("OVERSIZED"s);
+    sender.SendBroadcast("ABCD"s);
+    sender.SendBroadcast("XY"s);
+    std::this_thread::sleep_for(1ms);
+    received = receiver.AsyncRecvBroadcasts(mixed_buffers, 10ms);
+    fails += received == 2 ? 0 : 1;
+    fails += mixed_buffers[0].length == 4 && storage_medium == std::array<std::uint8_t, 4>({'A', 'B', 'C', 'D'}) ? 0 : 1;
+    fails += mixed_buffers[1].length == 2 && storage_large[0] == 'X' && storage_large[1] == 'Y' ? 0 : 1;
+    fails += receiver.GetStats().oversized == 2 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_recv_chain() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    std::array<std::array<std::uint8_t, 16>, 4> storage {};
+    std::array<BroadcastBuffer, 4> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+
+    // Stop receive chain after the second message
+    std::vector<std::string> msgs {};
+    receiver.StartRecvBroadcasts(buffers, [&](std::size_t received) {
+        for (std::size_t n = 0; n < received; ++n) {
+            msgs.emplace_back(storage[n].begin(), storage[n].begin() + static_cast<std::ptrdiff_t>(buffers[n].length));
+        }
+        if (msgs.size() >= 2) {
+            receiver.Stop();
+        }
+    });
+    auto run_future = std::async(&BroadcastRecv::Run, &receiver);
+    sender.SendBroadcast("first"s);
+    sender.SendBroadcast("second"s);
+    const auto run_status = run_future.wait_for(100ms);
+
+    int fails = 0;
+    fails += run_status == std::future_status::ready ? 0 : 1;
+    fails += msgs.size() == 2 && msgs[0] == "first" && msgs[1] == "second" ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_recv_chain_stop() {
+    BroadcastRecv receiver {"0.0.0.0"};
+
+    std::array<std::uint8_t, 16> storage {};
+    std::array<BroadcastBuffer, 1> buffers {};
+    buffers[0].buffer = storage;
+
+    int fails = 0;
+    // Test that stopping interrupts waiting
+    receiver.StartRecvBroadcasts(buffers, [](std::size_t) {});
+    auto run_future = std::async(&BroadcastRecv::Run, &receiver);
+    std::this_thread::sleep_for(5ms);
+    receiver.Stop();
+    fails += run_future.wait_for(10ms) == std::future_status::ready ? 0 : 1;
+    // Test that stopping before running returns immediately
+    receiver.StartRecvBroadcasts(buffers, [](std::size_t) {});
+    receiver.Stop();
+    run_future = std::async(&BroadcastRecv::Run, &receiver);
+    fails += run_future.wait_for(10ms) == std::future_status::ready ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_filter() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    // Accept only messages with six bytes starting with "TE" and with "T" at the fourth byte
+    if (!receiver.AttachFilter(6, {{0, {'T', 'E'}}, {3, {'T'}}})) {
+        // Kernel-level filtering not supported on this platform
+        return 0;
+    }
+    sender.SendBroadcast("TEST"s);
+    sender.SendBroadcast("FILTER"s);
+    sender.SendBroadcast("TESTER"s);
+    auto msg_opt = receiver.AsyncRecvBroadcast(10ms);
+
+    int fails = 0;
+    // Check that only matching message was received
+    fails += msg_opt.has_value() && msg_opt.value().content_to_string() == "TESTER" ? 0 : 1;
+    fails += receiver.AsyncRecvBroadcast(10ms).has_value() ? 1 : 0;
+    // Check that message is received after detaching filter
+    receiver.DetachFilter();
+    sender.SendBroadcast("FILTER"s);
+    fails += receiver.AsyncRecvBroadcast(10ms).has_value() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_buffer_size() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    int fails = 0;
+    // Test that buffer sizes are at least the requested size (might be larger due to operating system bookkeeping)
+    receiver.SetReceiveBufferSize(65536);
+    fails += receiver.GetReceiveBufferSize() >= 65536 ? 0 : 1;
+    sender.SetSendBufferSize(65536);
+    fails += sender.GetSendBufferSize() >= 65536 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_recv_stats() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    std::array<std::array<std::uint8_t, 4>, 8> storage {};
+    std::array<BroadcastBuffer, 8> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+
+    // Overflow smallest possible socket receive buffer
+    receiver.SetReceiveBufferSize(1);
+    for (int n = 0; n < 100; ++n) {
+        sender.SendBroadcast("TEST"s);
+    }
+    // Receive remaining messages, which reports the number of dropped messages
+    receiver.AsyncRecvBroadcasts(buffers, 10ms);
+    // Send oversized message
+    sender.SendBroadcast("OVERSIZED"s);
+    sender.SendBroadcast("TEST"s);
+    receiver.AsyncRecvBroadcasts(buffers, 10ms);
+
+    const auto stats = receiver.GetStats();
+    int fails = 0;
+    fails += stats.oversized == 1 ? 0 : 1;
+#ifdef __linux__
+    // Test that dropped messages are reported
+    fails += stats.kernel_drops > 0 ? 0 : 1;
+    fails += stats.filter_drops == 0 ? 0 : 1;
+
+    // Test that messages rejected by the filter are not reported as overflow
+    receiver.SetReceiveBufferSize(65536);
+    if (receiver.AttachFilter(4, {})) {
+        for (int n = 0; n < 3; ++n) {
+            sender.SendBroadcast("FILTER"s);
+        }
+        sender.SendBroadcast("TEST"s);
+        receiver.AsyncRecvBroadcasts(buffers, 10ms);
+        const auto filter_stats = receiver.GetStats();
+        fails += filter_stats.kernel_drops == stats.kernel_drops ? 0 : 1;
+        fails += filter_stats.filter_drops == 3 ? 0 : 1;
+    }
+#endif
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_timestamps() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+    const auto timestamps = receiver.EnableTimestamps();
+
+    std::array<BroadcastMessage, 1> messages {};
+    const auto send_time = std::chrono::system_clock::now();
+    sender.SendBroadcast("TEST"s);
+    const auto count = receiver.AsyncRecvBroadcasts(messages, 10ms);
+
+    int fails = 0;
+    fails += count == 1 ? 0 : 1;
+#ifdef __linux__
+    // Test that kernel receive timestamp is set and sensible
+    fails += timestamps ? 0 : 1;
+    fails += messages[0].timestamp.has_value() ? 0 : 1;
+    fails += messages[0].timestamp.value_or(send_time) - send_time < 1s ? 0 : 1;
+#else
+    fails += !timestamps && !messages[0].timestamp.has_value() ? 0 : 1;
+#endif
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_packet_info() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"127.255.255.255"};
+    const auto packet_info = receiver.EnablePacketInfo();
+
+    std::array<BroadcastMessage, 1> messages {};
+    sender.SendBroadcast("TEST"s);
+    const auto count = receiver.AsyncRecvBroadcasts(messages, 10ms);
+
+    int fails = 0;
+    fails += count == 1 ? 0 : 1;
+#ifdef __linux__
+    // Test that broadcast is reported to arrive on the loopback interface
+    fails += packet_info ? 0 : 1;
+    fails += messages[0].interface_index == ::if_nametoindex("lo") ? 0 : 1;
+#else
+    fails += !packet_info && messages[0].interface_index == 0 ? 0 : 1;
+#endif
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_multicast() {
+    try {
+        BroadcastRecv receiver {"0.0.0.0"};
+        receiver.JoinMulticastGroup(asio::ip::make_address("239.192.7.123"));
+        BroadcastSend sender {"239.192.7.123"};
+
+        // Send and receive multicast message
+        sender.SendBroadcast("TEST"s);
+        const auto msg = receiver.AsyncRecvBroadcast(10ms);
+
+        int fails = 0;
+        fails += msg.has_value() && msg.value().content_to_string() == "TEST" ? 0 : 1;
+        // Test that multicast message is not looped back if disabled
+        sender.SetMulticastLoopback(false);
+        sender.SendBroadcast("TEST"s);
+        fails += receiver.AsyncRecvBroadcast(10ms).has_value() ? 1 : 0;
+        return fails == 0 ? 0 : 1;
+    }
+    catch (const asio::system_error&) {
+        // No multicast route available
+        return 0;
+    }
+}
+
+int test_broadcast_await_recv() {
+    asio::io_context io_context {};
+    BroadcastRecv receiver {io_context.get_executor(), asio::ip::address_v4::any()};
+    BroadcastSend sender {"0.0.0.0"};
+
+    std::array<std::array<std::uint8_t, 16>, 4> storage {};
+    std::array<BroadcastBuffer, 4> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+
+    std::string msg_content {};
+    std::size_t count = 0;
+    bool cancelled = false;
+    asio::co_spawn(
+        io_context,
+        [&]() -> asio::awaitable<void> {
+            // Await single message
+            const auto msg = co_await receiver.AwaitRecvBroadcast();
+            msg_content = msg.content_to_string();
+            // Await multiple messages
+            count = co_await receiver.AwaitRecvBroadcasts(buffers);
+            // Await message that never arrives
+            try {
+                co_await receiver.AwaitRecvBroadcast();
+            }
+            catch (const asio::system_error& error) {
+                cancelled = error.code() == asio::error::operation_aborted;
+            }
+        },
+        asio::detached);
+
+    // Coroutine suspends until message is received
+    io_context.run_for(5ms);
+    sender.SendBroadcast("TEST"s);
+    io_context.run_for(5ms);
+    sender.SendBroadcast("TEST1"s);
+    sender.SendBroadcast("TEST2"s);
+    io_context.run_for(5ms);
+    receiver.Cancel();
+    io_context.run_for(5ms);
+
+    int fails = 0;
+    fails += msg_content == "TEST" ? 0 : 1;
+    fails += count == 2 ? 0 : 1;
+    fails += cancelled ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_io_uring() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+    if (!receiver.EnableIoUring()) {
+        // io_uring not supported on this platform or build
+        return 0;
+    }
+
+    int fails = 0;
+    // Receive single message
+    sender.SendBroadcast("TEST"s);
+    const auto msg = receiver.AsyncRecvBroadcast(10ms);
+    fails += msg.has_value() && msg.value().content_to_string() == "TEST" ? 0 : 1;
+    fails += receiver.AsyncRecvBroadcast(1ms).has_value() ? 1 : 0;
+    // Receive more messages than buffers in the buffer ring
+    std::vector<BroadcastMessage> msgs(512);
+    for (std::size_t n = 0; n < msgs.size(); ++n) {
+        sender.SendBroadcast("TEST" + std::to_string(n));
+    }
+    std::size_t received = 0;
+    while (received < msgs.size()) {
+        const auto count = receiver.AsyncRecvBroadcasts(std::span(msgs).subspan(received), 10ms);
+        if (count == 0) {
+            break;
+        }
+        received += count;
+    }
+    fails += received == msgs.size() ? 0 : 1;
+    fails += msgs.back().content_to_string() == "TEST511" ? 0 : 1;
+    // Receive message blocking
+    sender.SendBroadcast("TEST"s);
+    fails += receiver.RecvBroadcast().content_to_string() == "TEST" ? 0 : 1;
+    // Receive message via receive chain
+    std::array<std::array<std::uint8_t, 16>, 4> storage {};
+    std::array<BroadcastBuffer, 4> buffers {};
+    for (std::size_t n = 0; n < buffers.size(); ++n) {
+        buffers[n].buffer = storage[n];
+    }
+    std::size_t chain_received = 0;
+    receiver.StartRecvBroadcasts(buffers, [&](std::size_t count) {
+        chain_received += count;
+        receiver.Stop();
+    });
+    sender.SendBroadcast("TEST"s);
+    receiver.Run();
+    fails += chain_received == 1 ? 0 : 1;
+    // Test that receiving continues after the thread which started the receive operation exited
+    std::async(std::launch::async, [&]() { return receiver.AsyncRecvBroadcast(1ms); }).wait();
+    sender.SendBroadcast("TEST"s);
+    const auto msg_after_exit = receiver.AsyncRecvBroadcast(10ms);
+    fails += msg_after_exit.has_value() && msg_after_exit.value().content_to_string() == "TEST" ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+// Test that messages after a message which cannot be sent are still sent, with the error reported for that message
+int check_send_partial_failure(BroadcastRecv& receiver, BroadcastSend& sender) {
+    const std::string msg_content_0 {"TEST0"};
+    const std::string oversized(70000, 'X');
+    const std::string msg_content_2 {"TEST2"};
+    const std::array<asio::const_buffer, 3> buffers {asio::buffer(msg_content_0), asio::buffer(oversized), asio::buffer(msg_content_2)};
+    std::array<asio::error_code, 3> errors {};
+
+    int fails = 0;
+    fails += sender.TrySendBroadcasts(buffers, errors) == 2 ? 0 : 1;
+    fails += !errors[0] && errors[1] == asio::error::message_size && !errors[2] ? 0 : 1;
+    std::vector<BroadcastMessage> msgs(4);
+    std::size_t received = 0;
+    while (received < msgs.size()) {
+        const auto count = receiver.AsyncRecvBroadcasts(std::span(msgs).subspan(received), 10ms);
+        if (count == 0) {
+            break;
+        }
+        received += count;
+    }
+    fails += received == 2 ? 0 : 1;
+    fails += msgs[1].content_to_string() == "TEST2" ? 0 : 1;
+
+    // Test that the error is thrown after sending the other messages
+    try {
+        sender.SendBroadcasts(buffers);
+        fails += 1;
+    }
+    catch (const asio::system_error& error) {
+        fails += error.code() == asio::error::message_size ? 0 : 1;
+    }
+    fails += receiver.AsyncRecvBroadcasts(std::span(msgs), 10ms) > 0 ? 0 : 1;
+    return fails;
+}
+
+int test_broadcast_send_batch() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+
+    // Send more messages than sent per system call
+    std::vector<std::string> msg_contents {};
+    for (int n = 0; n < 100; ++n) {
+        msg_contents.push_back("TEST" + std::to_string(n));
+    }
+    std::vector<asio::const_buffer> buffers {};
+    for (const auto& msg_content : msg_contents) {
+        buffers.push_back(asio::buffer(msg_content));
+    }
+    sender.SendBroadcasts(buffers);
+
+    // Receive all messages
+    std::vector<BroadcastMessage> msgs(128);
+    std::size_t received = 0;
+    while (received < msgs.size()) {
+        const auto count = receiver.AsyncRecvBroadcasts(std::span(msgs).subspan(received), 10ms);
+        if (count == 0) {
+            break;
+        }
+        received += count;
+    }
+
+    int fails = 0;
+    fails += received == 100 ? 0 : 1;
+    fails += msgs[0].content_to_string() == "TEST0" ? 0 : 1;
+    fails += msgs[99].content_to_string() == "TEST99" ? 0 : 1;
+    fails += check_send_partial_failure(receiver, sender);
+    return fails == 0 ? 0 : 1;
+}
+
+int test_broadcast_send_io_uring() {
+    BroadcastRecv receiver {"0.0.0.0"};
+    BroadcastSend sender {"0.0.0.0"};
+    if (!sender.EnableIoUring()) {
+        // io_uring not supported on this platform or build
+        return 0;
+    }
+
+    int fails = 0;
+    // Send single message
+    sender.SendBroadcast("TEST"s);
+    const auto msg = receiver.AsyncRecvBroadcast(10ms);
+    fails += msg.has_value() && msg.value().content_to_string() == "TEST" ? 0 : 1;
+
+    // Send more messages than submitted per system call
+    std::vector<std::string> msg_contents {};
+    for (int n = 0; n < 100; ++n) {
+        msg_contents.push_back("TEST" + std::to_string(n));
+    }
+    std::vector<asio::const_buffer> buffers {};
+    for (const auto& msg_content : msg_contents) {
+        buffers.push_back(asio::buffer(msg_content));
+    }
+    sender.SendBroadcasts(buffers);
+    std::vector<BroadcastMessage> msgs(128);
+    std::size_t received = 0;
+    while (received < msgs.size()) {
+        const auto count = receiver.AsyncRecvBroadcasts(std::span(msgs).subspan(received), 10ms);
+        if (count == 0) {
+            break;
+        }
+        received += count;
+    }
+    fails += received == 100 ? 0 : 1;
+    fails += msgs[0].content_to_string() == "TEST0" ? 0 : 1;
+    fails += msgs[99].content_to_string() == "TEST99" ? 0 : 1;
+
+    // Test that each batch was submitted with a single system call
+    fails += sender.GetSyscalls() == 3 ? 0 : 1;
+    fails += check_send_partial_failure(receiver, sender);
+    return fails == 0 ? 0 : 1;
+}
+
 int main() {
     int ret = 0;
     int ret_test = 0;
@@ -121,6 +633,96 @@ int main() {
     std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
     ret += ret_test;
 
+    // test_broadcast_send_async_recv_batch
+    std::cout << "test_broadcast_send_async_recv_batch...      " << std::flush;
+    ret_test = test_broadcast_send_async_recv_batch();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_async_recv_batch_timeout
+    std::cout << "test_broadcast_async_recv_batch_timeout...   " << std::flush;
+    ret_test = test_broadcast_async_recv_batch_timeout();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_async_recv_buffers
+    std::cout << "test_broadcast_async_recv_buffers...         " << std::flush;
+    ret_test = test_broadcast_async_recv_buffers();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_recv_chain
+    std::cout << "test_broadcast_recv_chain...                 " << std::flush;
+    ret_test = test_broadcast_recv_chain();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_recv_chain_stop
+    std::cout << "test_broadcast_recv_chain_stop...            " << std::flush;
+    ret_test = test_broadcast_recv_chain_stop();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_filter
+    std::cout << "test_broadcast_filter...                     " << std::flush;
+    ret_test = test_broadcast_filter();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_buffer_size
+    std::cout << "test_broadcast_buffer_size...                " << std::flush;
+    ret_test = test_broadcast_buffer_size();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_recv_stats
+    std::cout << "test_broadcast_recv_stats...                 " << std::flush;
+    ret_test = test_broadcast_recv_stats();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_timestamps
+    std::cout << "test_broadcast_timestamps...                 " << std::flush;
+    ret_test = test_broadcast_timestamps();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_packet_info
+    std::cout << "test_broadcast_packet_info...                " << std::flush;
+    ret_test = test_broadcast_packet_info();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_multicast
+    std::cout << "test_broadcast_multicast...                  " << std::flush;
+    ret_test = test_broadcast_multicast();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_await_recv
+    std::cout << "test_broadcast_await_recv...                 " << std::flush;
+    ret_test = test_broadcast_await_recv();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_io_uring
+    std::cout << "test_broadcast_io_uring...                   " << std::flush;
+    ret_test = test_broadcast_io_uring();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_send_batch
+    std::cout << "test_broadcast_send_batch...                 " << std::flush;
+    ret_test = test_broadcast_send_batch();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_broadcast_send_io_uring
+    std::cout << "test_broadcast_send_io_uring...              " << std::flush;
+    ret_test = test_broadcast_send_io_uring();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
     if (ret == 0) {
         std::cout << "\nAll tests passed" << std::endl;
     }
@@ -1,9 +1,27 @@
+#include <algorithm>
 #include <any>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <iostream>
 #include <future>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
 #include <thread>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "asio.hpp"
 
@@ -11,10 +29,45 @@
 #include "CHIRP/BroadcastSend.hpp"
 #include "CHIRP/Manager.hpp"
 #include "CHIRP/Message.hpp"
+#include "CHIRP/NetworkInterface.hpp"
+#include "CHIRP/TimingWheel.hpp"
+
+#ifdef __linux__
+#include <net/if.h>
+#endif
 
 using namespace cnstln::CHIRP;
 using namespace std::literals::chrono_literals;
 
+// Count heap allocations of all threads to test allocation-free code paths
+std::atomic_size_t allocation_count {0};
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC falsely reports a mismatch when the replaced operators are inlined into coroutine frame deallocation
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 int test_manager_sort_registered_service() {
     int fails = 0;
     // test self not smaller than self
@@ -49,6 +102,244 @@ int test_manager_sort_discovered_service() {
     return fails == 0 ? 0 : 1;
 }
 
+int test_manager_hash_services() {
+    auto ip_1 = asio::ip::make_address("1.2.3.4");
+    auto ip_2 = asio::ip::make_address("4.3.2.1");
+    int fails = 0;
+    // Test that registered services can be stored in hash containers
+    std::unordered_set<RegisteredService> registered_services {};
+    registered_services.insert({CONTROL, 23999});
+    registered_services.insert({DATA, 23999});
+    registered_services.insert({CONTROL, 23999});
+    fails += registered_services.size() == 2 ? 0 : 1;
+    fails += registered_services.contains({DATA, 23999}) ? 0 : 1;
+    fails += registered_services.contains({DATA, 24000}) ? 1 : 0;
+
+    // Test that discovered services ignore the ip for equality and hashing
+    std::unordered_set<DiscoveredService> discovered_services {};
+    discovered_services.insert({ip_1, MD5Hash("a"), DATA, 0});
+    discovered_services.insert({ip_2, MD5Hash("a"), DATA, 0});
+    discovered_services.insert({ip_1, MD5Hash("b"), DATA, 0});
+    fails += discovered_services.size() == 2 ? 0 : 1;
+    fails += discovered_services.contains({ip_2, MD5Hash("b"), DATA, 0}) ? 0 : 1;
+    fails += discovered_services.contains({ip_1, MD5Hash("b"), CONTROL, 0}) ? 1 : 0;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_discovered_service_table() {
+    auto ip_1 = asio::ip::make_address("1.2.3.4");
+    DiscoveredServiceTable table {};
+    std::set<DiscoveredService> reference {};
+    std::minstd_rand random {1};
+    int fails = 0;
+
+    // Test random inserts and removals against ordered set, with few hosts such that probe sequences collide
+    for (int n = 0; n < 20000; ++n) {
+        const DiscoveredService service {ip_1,
+                                         MD5Hash("sat" + std::to_string(random() % 64)),
+                                         static_cast<ServiceIdentifier>(1 + random() % 4),
+                                         static_cast<Port>(random() % 8)};
+        if (random() % 3 == 0) {
+            fails += table.Erase(service) == (reference.erase(service) > 0) ? 0 : 1;
+        }
+        else {
+            fails += table.Insert(service) == reference.insert(service).second ? 0 : 1;
+        }
+        fails += table.Contains(service) == reference.contains(service) ? 0 : 1;
+    }
+    fails += table.Size() == reference.size() ? 0 : 1;
+
+    // Test that services are counted per host
+    const MD5Hash host_1 {"sat1"};
+    fails += table.CountServices(host_1) == static_cast<std::size_t>(std::ranges::count(reference, host_1, &DiscoveredService::host_id)) ? 0 : 1;
+    fails += table.CountServices(MD5Hash("sat64")) == 0 ? 0 : 1;
+
+    // Test that listed services match, both all and filtered by service identifier
+    auto services = table.GetServices();
+    std::sort(services.begin(), services.end());
+    fails += std::ranges::equal(services, reference) ? 0 : 1;
+    auto data_services = table.GetServices(DATA);
+    std::sort(data_services.begin(), data_services.end());
+    fails += std::ranges::equal(data_services, reference | std::views::filter([](const auto& service) { return service.identifier == DATA; })) ? 0 : 1;
+
+    // Test that all services are removed
+    table.Clear();
+    fails += table.Size() == 0 && table.GetServices(DATA).empty() ? 0 : 1;
+    fails += table.Contains(*reference.begin()) ? 1 : 0;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_discovered_service_changes() {
+    auto ip_1 = asio::ip::make_address("1.2.3.4");
+    DiscoveredServiceTable table {16};
+    std::set<DiscoveredService> tracked {};
+    std::uint64_t generation = 0;
+    std::minstd_rand random {1};
+    int fails = 0;
+
+    // Apply changes to tracked services, replacing them on reset
+    const auto apply_changes = [&](const DiscoveredServiceChanges& changes) {
+        if (changes.reset) {
+            tracked.clear();
+        }
+        for (const auto& change : changes.changes) {
+            if (change.depart) {
+                tracked.erase(change.service);
+            }
+            else {
+                tracked.insert(change.service);
+            }
+        }
+        generation = changes.generation;
+    };
+
+    // Test that polling changes at random intervals keeps tracked services in sync, with and without overflowing
+    bool had_reset = false;
+    for (int n = 0; n < 5000; ++n) {
+        const DiscoveredService service {ip_1,
+                                         MD5Hash("sat" + std::to_string(random() % 16)),
+                                         static_cast<ServiceIdentifier>(1 + random() % 4),
+                                         static_cast<Port>(random() % 4)};
+        if (random() % 3 == 0) {
+            table.Erase(service);
+        }
+        else {
+            table.Insert(service);
+        }
+        if (random() % 8 == 0) {
+            const auto changes = table.GetChanges(generation);
+            fails += changes.generation == table.GetGeneration() ? 0 : 1;
+            fails += changes.reset || changes.changes.size() <= 16 ? 0 : 1;
+            had_reset |= changes.reset;
+            apply_changes(changes);
+            auto services = table.GetServices();
+            std::sort(services.begin(), services.end());
+            fails += std::ranges::equal(services, tracked) ? 0 : 1;
+        }
+    }
+    fails += had_reset ? 0 : 1;
+
+    // Test that only changes are returned and that no changes are returned if nothing changed
+    apply_changes(table.GetChanges(generation));
+    const DiscoveredService service {ip_1, MD5Hash("new"), DATA, 24000};
+    table.Insert(service);
+    table.Insert(service);
+    const auto changes = table.GetChanges(generation);
+    fails += !changes.reset && changes.changes.size() == 1 ? 0 : 1;
+    fails += changes.changes.front().service == service && !changes.changes.front().depart ? 0 : 1;
+    fails += changes.changes.front().generation == changes.generation ? 0 : 1;
+    apply_changes(changes);
+    fails += table.GetChanges(generation).changes.empty() ? 0 : 1;
+
+    // Test that clearing results in a reset
+    table.Clear();
+    const auto cleared = table.GetChanges(generation);
+    fails += cleared.reset && cleared.changes.empty() && cleared.generation > generation ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_timing_wheel() {
+    TimingWheel wheel {};
+    std::map<std::uint32_t, std::uint64_t> reference {};
+    std::vector<TimingWheel::TimerID> timers {};
+    std::minstd_rand random {1};
+    std::uint32_t next_value = 0;
+    int fails = 0;
+
+    // Test random timers against reference, with delays and advances spanning all wheels and beyond
+    const auto random_delay = [&]() -> std::uint64_t {
+        const auto bits = random() % 28;
+        return 1 + random() % (std::uint64_t(1) << bits);
+    };
+    for (int n = 0; n < 20000; ++n) {
+        const auto action = random() % 8;
+        if (action < 4 || timers.empty()) {
+            const auto expiry = wheel.GetTick() + random_delay();
+            const auto value = next_value++;
+            timers.resize(std::max<std::size_t>(timers.size(), value + 1), TimingWheel::NO_TIMER);
+            timers[value] = wheel.Add(expiry, value);
+            reference[value] = expiry;
+        }
+        else if (action == 4 && !reference.empty()) {
+            auto it = reference.begin();
+            std::advance(it, random() % reference.size());
+            it->second = wheel.GetTick() + random_delay();
+            wheel.Reschedule(timers[it->first], it->second);
+        }
+        else if (action == 5 && !reference.empty()) {
+            auto it = reference.begin();
+            std::advance(it, random() % reference.size());
+            wheel.Remove(timers[it->first]);
+            reference.erase(it);
+        }
+        else {
+            const auto tick = wheel.GetTick() + random_delay() / 64;
+            wheel.Advance(tick, [&](std::uint32_t value) {
+                // Test that timer expired on time
+                const auto it = reference.find(value);
+                fails += it != reference.end() && it->second <= wheel.GetTick() && wheel.GetTick() <= tick ? 0 : 1;
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+            });
+            // Test that no timer is left behind
+            fails += std::ranges::none_of(reference, [&](const auto& timer) { return timer.second <= tick; }) ? 0 : 1;
+            fails += wheel.Size() == reference.size() ? 0 : 1;
+            // Test that next tick does not skip a timer
+            const auto next_tick = wheel.GetNextTick();
+            if (!reference.empty()) {
+                const auto earliest = std::ranges::min(reference | std::views::values);
+                fails += next_tick.has_value() && next_tick.value() > tick && next_tick.value() <= earliest ? 0 : 1;
+            }
+        }
+    }
+
+    // Test that all timers expire eventually
+    std::size_t expired = 0;
+    wheel.Advance(std::numeric_limits<std::uint64_t>::max(), [&](std::uint32_t /*value*/) { ++expired; });
+    fails += expired == reference.size() && wheel.Size() == 0 && !wheel.GetNextTick().has_value() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_discovered_service_expiry() {
+    auto ip_1 = asio::ip::make_address("1.2.3.4");
+    DiscoveredServiceTable table {};
+    int fails = 0;
+
+    const DiscoveredService service_1 {ip_1, MD5Hash("sat1"), CONTROL, 23999};
+    const DiscoveredService service_2 {ip_1, MD5Hash("sat2"), CONTROL, 23999};
+    const DiscoveredService service_3 {ip_1, MD5Hash("sat3"), DATA, 24000};
+    fails += table.Refresh(service_1, 100) ? 0 : 1;
+    fails += table.Refresh(service_2, 200) ? 0 : 1;
+    fails += table.Insert(service_3) ? 0 : 1;
+    // Test that refreshing does not insert again but delays the expiry
+    fails += table.Refresh(service_1, 300) ? 1 : 0;
+
+    std::vector<DiscoveredService> expired {};
+    table.Expire(150, expired);
+    fails += expired.empty() ? 0 : 1;
+    table.Expire(250, expired);
+    fails += expired.size() == 1 && expired[0] == service_2 ? 0 : 1;
+    fails += table.Contains(service_2) ? 1 : 0;
+    // Test that expired services are recorded as departed
+    const auto changes = table.GetChanges(table.GetGeneration() - 1);
+    fails += changes.changes.size() == 1 && changes.changes[0].depart ? 0 : 1;
+
+    // Test that removed services do not expire and services without expiry stay
+    table.Erase(service_1);
+    expired.clear();
+    table.Expire(1000, expired);
+    fails += expired.empty() && table.Size() == 1 && table.Contains(service_3) ? 0 : 1;
+    fails += table.GetNextExpiryTick().has_value() ? 1 : 0;
+
+    // Test that expiries can be removed
+    table.Refresh(service_1, 1100);
+    table.ClearExpiries();
+    table.Expire(2000, expired);
+    fails += expired.empty() && table.Size() == 2 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
 int test_manager_sort_discover_callback_entry() {
     auto* cb1 = reinterpret_cast<DiscoverCallback*>(1);
     auto* cb2 = reinterpret_cast<DiscoverCallback*>(2);
@@ -120,6 +411,305 @@ int test_manager_register_callback_logic() {
     return fails == 0 ? 0 : 1;
 }
 
+int test_manager_callback_threads() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetCallbackThreads(2);
+    manager.Start();
+
+    // Record order of callbacks per port and the threads running them
+    struct CallbackLog {
+        std::mutex mutex;
+        std::map<Port, std::vector<bool>> departs;
+        std::set<std::thread::id> thread_ids;
+    } log {};
+    auto callback = [](DiscoveredService service, bool depart, std::any user_data) {
+        auto* log_l = std::any_cast<CallbackLog*>(user_data);
+        const std::lock_guard lock {log_l->mutex};
+        log_l->departs[service.port].push_back(depart);
+        log_l->thread_ids.insert(std::this_thread::get_id());
+    };
+    manager.RegisterDiscoverCallback(callback, CONTROL, &log);
+
+    // Send alternating OFFERs and DEPARTs for several services
+    for (int n = 0; n < 16; ++n) {
+        for (Port port = 23000; port < 23008; ++port) {
+            const auto asm_msg = Message(n % 2 == 0 ? OFFER : DEPART, "group1", "sat2", CONTROL, port).Assemble();
+            sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        }
+    }
+    std::this_thread::sleep_for(20ms);
+
+    int fails = 0;
+    const std::lock_guard lock {log.mutex};
+    // Test that callbacks of each service ran in order
+    fails += log.departs.size() == 8 ? 0 : 1;
+    for (const auto& [port, departs] : log.departs) {
+        for (std::size_t n = 0; n < departs.size(); ++n) {
+            fails += departs[n] == (n % 2 == 1) ? 0 : 1;
+        }
+    }
+    // Test that callbacks only ran on the callback threads
+    fails += log.thread_ids.size() <= 2 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_callback_unregister_full() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetCallbackThreads(1);
+    manager.Start();
+
+    struct CallbackState {
+        Manager* manager;
+        std::atomic_int calls;
+        std::atomic_bool unregistered;
+    } state {&manager, 0, false};
+    auto callback = [](DiscoveredService /*service*/, bool /*depart*/, std::any user_data) {
+        auto* state_l = std::any_cast<CallbackState*>(user_data);
+        if (state_l->calls.fetch_add(1) == 0) {
+            // Block first callback until the queue of the only callback thread is full, then unregister
+            std::this_thread::sleep_for(100ms);
+            state_l->manager->UnregisterDiscoverCallbacks();
+            state_l->unregistered.store(true);
+        }
+    };
+    manager.RegisterDiscoverCallback(callback, CONTROL, &state);
+
+    // Send more OFFERs than fit into the callback queue
+    for (Port offset = 0; offset < 20 * CHIRP_V2_MAX_SERVICES; offset += CHIRP_V2_MAX_SERVICES) {
+        MultiMessage multi_msg {OFFER, "group1", "sat2"};
+        for (Port port = 0; port < CHIRP_V2_MAX_SERVICES; ++port) {
+            multi_msg.AddService(CONTROL, 30000 + offset + port);
+        }
+        const auto asm_msg = multi_msg.Assemble();
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    }
+    for (int n = 0; n < 100 && !state.unregistered.load(); ++n) {
+        std::this_thread::sleep_for(10ms);
+    }
+    std::this_thread::sleep_for(50ms);
+
+    int fails = 0;
+    // Test that the callback unregistered itself and that the remaining OFFERs were handled
+    fails += state.unregistered.load() ? 0 : 1;
+    fails += manager.GetDiscoveredServices().size() == 20 * CHIRP_V2_MAX_SERVICES ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_callback_queue_full() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetCallbackThreads(1);
+    manager.Start();
+
+    struct CallbackState {
+        std::atomic_int calls;
+        std::atomic_bool released;
+    } state {0, false};
+    auto callback = [](DiscoveredService /*service*/, bool /*depart*/, std::any user_data) {
+        auto* state_l = std::any_cast<CallbackState*>(user_data);
+        if (state_l->calls.fetch_add(1) == 0) {
+            // Block first callback until released such that the queue of the only callback thread fills up
+            state_l->released.wait(false);
+        }
+    };
+    manager.RegisterDiscoverCallback(callback, CONTROL, &state);
+
+    // Send more OFFERs than fit into the callback queue
+    constexpr Port services = 20 * CHIRP_V2_MAX_SERVICES;
+    for (Port offset = 0; offset < services; offset += CHIRP_V2_MAX_SERVICES) {
+        MultiMessage multi_msg {OFFER, "group1", "sat2"};
+        for (Port port = 0; port < CHIRP_V2_MAX_SERVICES; ++port) {
+            multi_msg.AddService(CONTROL, 30000 + offset + port);
+        }
+        const auto asm_msg = multi_msg.Assemble();
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    }
+    std::this_thread::sleep_for(20ms);
+
+    // Test that the receiving thread waits for a free slot without using the CPU
+    const auto cpu_before = std::clock();
+    std::this_thread::sleep_for(100ms);
+    const auto cpu_time = std::chrono::duration<double>(static_cast<double>(std::clock() - cpu_before) / CLOCKS_PER_SEC);
+
+    int fails = 0;
+    fails += cpu_time < 20ms ? 0 : 1;
+    fails += state.calls.load() == 1 ? 0 : 1;
+
+    // Test that discovery completes once the callback is released
+    state.released.store(true);
+    state.released.notify_one();
+    for (int n = 0; n < 100 && state.calls.load() < services; ++n) {
+        std::this_thread::sleep_for(10ms);
+    }
+    fails += state.calls.load() == services ? 0 : 1;
+    fails += manager.GetDiscoveredServices().size() == services ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_batch_callbacks() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.Start();
+
+    // Record sizes of delivered batches and all delivered events
+    struct BatchLog {
+        std::mutex mutex;
+        std::vector<std::size_t> sizes;
+        std::vector<DiscoverEvent> events;
+    } window_log {}, count_log {};
+    auto callback = [](std::span<const DiscoverEvent> events, std::any user_data) {
+        auto* log_l = std::any_cast<BatchLog*>(user_data);
+        const std::lock_guard lock {log_l->mutex};
+        log_l->sizes.push_back(events.size());
+        log_l->events.insert(log_l->events.end(), events.begin(), events.end());
+    };
+
+    int fails = 0;
+    fails += manager.RegisterDiscoverBatchCallback(callback, CONTROL, &window_log, 20ms, 1000) ? 0 : 1;
+    fails += manager.RegisterDiscoverBatchCallback(callback, CONTROL, &window_log, 20ms, 1000) ? 1 : 0;
+    fails += manager.RegisterDiscoverBatchCallback(callback, DATA, &count_log, 10s, 4) ? 0 : 1;
+
+    // Send OFFERs followed by DEPARTs
+    for (const auto type : {OFFER, DEPART}) {
+        for (Port port = 23000; port < 23008; ++port) {
+            const auto asm_msg_control = Message(type, "group1", "sat2", CONTROL, port).Assemble();
+            sender.SendBroadcast(asm_msg_control.data(), asm_msg_control.size());
+            const auto asm_msg_data = Message(type, "group1", "sat2", DATA, port).Assemble();
+            sender.SendBroadcast(asm_msg_data.data(), asm_msg_data.size());
+        }
+    }
+    std::this_thread::sleep_for(50ms);
+
+    {
+        // Test that events within the time window are delivered in one batch and in order
+        const std::lock_guard lock {window_log.mutex};
+        fails += window_log.sizes == std::vector<std::size_t>({16}) ? 0 : 1;
+        for (std::size_t n = 0; n < window_log.events.size(); ++n) {
+            fails += window_log.events[n].service.identifier == CONTROL ? 0 : 1;
+            fails += window_log.events[n].service.port == 23000 + n % 8 ? 0 : 1;
+            fails += window_log.events[n].depart == (n >= 8) ? 0 : 1;
+        }
+    }
+    {
+        // Test that batches are delivered once full without waiting for the time window
+        const std::lock_guard lock {count_log.mutex};
+        fails += count_log.sizes == std::vector<std::size_t>({4, 4, 4, 4}) ? 0 : 1;
+    }
+
+    // Test that unregistered batch callbacks are not called
+    fails += manager.UnregisterDiscoverBatchCallback(callback, CONTROL) ? 0 : 1;
+    fails += manager.UnregisterDiscoverBatchCallback(callback, CONTROL) ? 1 : 0;
+    const auto asm_msg = Message(OFFER, "group1", "sat2", CONTROL, 24000).Assemble();
+    sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    std::this_thread::sleep_for(30ms);
+    const std::lock_guard lock {window_log.mutex};
+    fails += window_log.sizes.size() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_service_ttl() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetServiceTTL(30ms);
+    manager.Start();
+
+    std::atomic_int departs {0};
+    auto callback = [](DiscoveredService /*service*/, bool depart, std::any user_data) {
+        if (depart) {
+            ++(*std::any_cast<std::atomic_int*>(user_data));
+        }
+    };
+    manager.RegisterDiscoverCallback(callback, CONTROL, &departs);
+
+    // Test that services refreshed within their time to live stay
+    const auto asm_msg_1 = Message(OFFER, "group1", "sat2", CONTROL, 23999).Assemble();
+    const auto asm_msg_2 = Message(OFFER, "group1", "sat3", CONTROL, 23999).Assemble();
+    sender.SendBroadcast(asm_msg_1.data(), asm_msg_1.size());
+    sender.SendBroadcast(asm_msg_2.data(), asm_msg_2.size());
+    for (int n = 0; n < 6; ++n) {
+        std::this_thread::sleep_for(10ms);
+        sender.SendBroadcast(asm_msg_1.data(), asm_msg_1.size());
+    }
+
+    int fails = 0;
+    const auto services = manager.GetDiscoveredServices();
+    fails += services.size() == 1 && services[0].host_id == MD5Hash("sat2") ? 0 : 1;
+    fails += departs.load() == 1 ? 0 : 1;
+
+    // Test that services expire once no longer refreshed
+    std::this_thread::sleep_for(50ms);
+    fails += manager.GetDiscoveredServices().empty() ? 0 : 1;
+    fails += departs.load() == 2 ? 0 : 1;
+
+    // Test that services do not expire after disabling the time to live
+    manager.SetServiceTTL(0ms);
+    sender.SendBroadcast(asm_msg_1.data(), asm_msg_1.size());
+    std::this_thread::sleep_for(50ms);
+    fails += manager.GetDiscoveredServices().size() == 1 ? 0 : 1;
+
+    // Test that setting the time to live expires services discovered before
+    manager.SetServiceTTL(10ms);
+    std::this_thread::sleep_for(30ms);
+    fails += manager.GetDiscoveredServices().empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_service_ttl_race() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetServiceTTL(2ms);
+    manager.Start();
+
+    // Record order of events per port from callbacks and batch callbacks
+    struct EventLog {
+        std::mutex mutex;
+        std::map<Port, std::vector<bool>> departs;
+    } callback_log {}, batch_log {};
+    auto callback = [](DiscoveredService service, bool depart, std::any user_data) {
+        auto* log_l = std::any_cast<EventLog*>(user_data);
+        const std::lock_guard lock {log_l->mutex};
+        log_l->departs[service.port].push_back(depart);
+    };
+    auto batch_callback = [](std::span<const DiscoverEvent> events, std::any user_data) {
+        auto* log_l = std::any_cast<EventLog*>(user_data);
+        const std::lock_guard lock {log_l->mutex};
+        for (const auto& event : events) {
+            log_l->departs[event.service.port].push_back(event.depart);
+        }
+    };
+    manager.RegisterDiscoverCallback(callback, CONTROL, &callback_log);
+    manager.RegisterDiscoverBatchCallback(batch_callback, CONTROL, &batch_log, 1ms, 1000);
+
+    // Refresh services around their time to live such that OFFERs race with their expiry
+    MultiMessage multi_msg {OFFER, "group1", "sat2"};
+    for (Port port = 23000; port < 23008; ++port) {
+        multi_msg.AddService(CONTROL, port);
+    }
+    const auto asm_msg = multi_msg.Assemble();
+    for (int n = 0; n < 300; ++n) {
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+        std::this_thread::sleep_for(std::chrono::microseconds(1000 + 500 * (n % 4)));
+    }
+    std::this_thread::sleep_for(50ms);
+
+    int fails = 0;
+    // Test that events of each service alternate, starting with the discovery and ending with the expiry
+    for (auto* log : {&callback_log, &batch_log}) {
+        const std::lock_guard lock {log->mutex};
+        fails += log->departs.size() == 8 ? 0 : 1;
+        for (const auto& [port, departs] : log->departs) {
+            fails += departs.size() % 2 == 0 ? 0 : 1;
+            for (std::size_t n = 0; n < departs.size(); ++n) {
+                fails += departs[n] == (n % 2 == 1) ? 0 : 1;
+            }
+        }
+    }
+    fails += manager.GetDiscoveredServices().empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
 int test_manager_async_timeout() {
     Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
     manager.Start();
@@ -206,6 +796,91 @@ int test_manager_discovery() {
     return fails == 0 ? 0 : 1;
 }
 
+int test_manager_discovered_services_snapshot() {
+    Manager manager1 {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"0.0.0.0", "0.0.0.0", "group1", "sat2"};
+    manager2.Start();
+
+    int fails = 0;
+    const auto snapshot_0 = manager2.GetDiscoveredServicesSnapshot();
+    fails += snapshot_0->empty() ? 0 : 1;
+    // Test that unchanged services share the same snapshot
+    fails += manager2.GetDiscoveredServicesSnapshot() == snapshot_0 ? 0 : 1;
+
+    // Register services, should publish new snapshot
+    manager1.RegisterService(CONTROL, 23999);
+    manager1.RegisterService(DATA, 24000);
+    std::this_thread::sleep_for(5ms);
+    const auto snapshot_1 = manager2.GetDiscoveredServicesSnapshot();
+    fails += snapshot_1->size() == 2 ? 0 : 1;
+    fails += manager2.GetDiscoveredServicesSnapshot() == snapshot_1 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices() == *snapshot_1 ? 0 : 1;
+
+    // Test that held snapshots are not modified by departing services
+    manager1.UnregisterService(DATA, 24000);
+    std::this_thread::sleep_for(5ms);
+    const auto snapshot_2 = manager2.GetDiscoveredServicesSnapshot();
+    fails += snapshot_2->size() == 1 ? 0 : 1;
+    fails += snapshot_1->size() == 2 ? 0 : 1;
+    fails += snapshot_0->empty() ? 0 : 1;
+
+    // Test that forgetting services publishes new snapshot
+    manager2.ForgetDiscoveredServices();
+    fails += manager2.GetDiscoveredServicesSnapshot()->empty() ? 0 : 1;
+    fails += snapshot_2->size() == 1 ? 0 : 1;
+
+    // Test that callbacks find their service in the published services
+    std::atomic_int cb_found {-1};
+    auto callback = [](DiscoveredService service, bool /*depart*/, std::any cb_info) {
+        const auto manager_found = std::any_cast<std::pair<Manager*, std::atomic_int*>>(cb_info);
+        const auto services = manager_found.first->GetDiscoveredServices();
+        manager_found.second->store(std::ranges::count(services, service) == 1 ? 1 : 0);
+    };
+    manager2.RegisterDiscoverCallback(callback, HEARTBEAT, std::pair<Manager*, std::atomic_int*>(&manager2, &cb_found));
+    manager1.RegisterService(HEARTBEAT, 24001);
+    std::this_thread::sleep_for(5ms);
+    fails += cb_found.load() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_discovered_service_feed() {
+    Manager manager1 {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"0.0.0.0", "0.0.0.0", "group1", "sat2"};
+    manager2.Start();
+
+    int fails = 0;
+    fails += manager2.GetDiscoveredServicesGeneration() == 0 ? 0 : 1;
+    fails += manager2.GetDiscoveredServiceChanges(0).changes.empty() ? 0 : 1;
+
+    // Register services, should be reported as discovered
+    manager1.RegisterService(CONTROL, 23999);
+    manager1.RegisterService(DATA, 24000);
+    std::this_thread::sleep_for(5ms);
+    const auto changes_1 = manager2.GetDiscoveredServiceChanges(0);
+    fails += changes_1.generation == 2 && manager2.GetDiscoveredServicesGeneration() == 2 ? 0 : 1;
+    fails += !changes_1.reset && changes_1.changes.size() == 2 ? 0 : 1;
+    for (const auto& change : changes_1.changes) {
+        fails += change.service.host_id == manager1.GetHostID() && !change.depart ? 0 : 1;
+    }
+
+    // Unregister service, should only report departure
+    manager1.UnregisterService(DATA, 24000);
+    std::this_thread::sleep_for(5ms);
+    const auto changes_2 = manager2.GetDiscoveredServiceChanges(changes_1.generation);
+    if (changes_2.changes.size() == 1) {
+        fails += changes_2.changes[0].service.identifier == DATA && changes_2.changes[0].depart ? 0 : 1;
+    }
+    else {
+        fails += 1;
+    }
+
+    // Forget services, should reset
+    manager2.ForgetDiscoveredServices();
+    const auto changes_3 = manager2.GetDiscoveredServiceChanges(changes_2.generation);
+    fails += changes_3.reset && changes_3.changes.empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
 int test_manager_callbacks() {
     Manager manager1 {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
     Manager manager2 {"0.0.0.0", "0.0.0.0", "group1", "sat2"};
@@ -328,6 +1003,543 @@ int test_manager_decode_error() {
     return 0;
 }
 
+int test_manager_steady_state_allocations() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.Start();
+    manager.RegisterService(CONTROL, 23999);
+
+    // Assemble messages beforehand
+    const auto asm_msg_offer = Message(OFFER, "group1", "sat2", DATA, 24000).Assemble();
+    const auto asm_msg_request = Message(REQUEST, "group1", "sat2", CONTROL, 0).Assemble();
+    const auto asm_msg_other_group = Message(OFFER, "group2", "sat2", DATA, 24000).Assemble();
+
+    // First OFFER inserts the discovered service. The first REQUEST is also sent before counting, since the first reply
+    // of a thread allocates the buffer reused for all later replies.
+    sender.SendBroadcast(asm_msg_offer.data(), asm_msg_offer.size());
+    sender.SendBroadcast(asm_msg_request.data(), asm_msg_request.size());
+    std::this_thread::sleep_for(5ms);
+
+    // Send already known OFFERs, REQUESTs and messages from other groups
+    const auto allocations_before = allocation_count.load();
+    for (int n = 0; n < 100; ++n) {
+        sender.SendBroadcast(asm_msg_offer.data(), asm_msg_offer.size());
+        sender.SendBroadcast(asm_msg_request.data(), asm_msg_request.size());
+        sender.SendBroadcast(asm_msg_other_group.data(), asm_msg_other_group.size());
+    }
+    // Wait a bit ensure we received the messages
+    std::this_thread::sleep_for(10ms);
+    const auto allocations = allocation_count.load() - allocations_before;
+
+    int fails = 0;
+    // Test that the steady-state discovery loop did not allocate
+    fails += allocations == 0 ? 0 : 1;
+    // Test that the messages were actually received
+    fails += manager.GetDiscoveredServices().size() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_stop_latency() {
+    auto manager = std::make_unique<Manager>("0.0.0.0", "0.0.0.0", "group1", "sat1");
+    manager->Start();
+    // Wait a bit to ensure the run thread is waiting for messages
+    std::this_thread::sleep_for(5ms);
+
+    // Stopping should interrupt waiting immediately instead of after a polling timeout
+    const auto start = std::chrono::steady_clock::now();
+    manager.reset();
+    const auto stop_duration = std::chrono::steady_clock::now() - start;
+
+    return stop_duration < 10ms ? 0 : 1;
+}
+
+int test_manager_kernel_filter() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    if (!manager.EnableKernelFilter()) {
+        // Kernel-level filtering not supported on this platform
+        return 0;
+    }
+    manager.Start();
+
+    // Send messages from other group, with invalid header and with invalid length
+    const auto asm_msg_other_group = Message(OFFER, "group2", "sat2", CONTROL, 23999).Assemble();
+    auto asm_msg_invalid = Message(OFFER, "group1", "sat2", CONTROL, 23999).Assemble();
+    asm_msg_invalid[0] = 'X';
+    const auto asm_msg_valid = Message(OFFER, "group1", "sat2", DATA, 24000).Assemble();
+    sender.SendBroadcast(asm_msg_other_group.data(), asm_msg_other_group.size());
+    sender.SendBroadcast(asm_msg_invalid.data(), asm_msg_invalid.size());
+    sender.SendBroadcast(asm_msg_valid.data(), asm_msg_valid.size() - 1);
+    // Send valid message
+    sender.SendBroadcast(asm_msg_valid.data(), asm_msg_valid.size());
+    std::this_thread::sleep_for(5ms);
+
+    // Test that valid message passed the filter
+    int fails = 0;
+    const auto services = manager.GetDiscoveredServices();
+    fails += services.size() == 1 && services[0].identifier == DATA ? 0 : 1;
+#ifdef __linux__
+    // Test that the other messages were dropped by the filter
+    fails += manager.GetRecvStats().filter_drops == 3 ? 0 : 1;
+#endif
+
+    // Test that the filter lets CHIRP v2 messages pass once enabled
+    auto asm_msg_v2 = asm_msg_valid;
+    asm_msg_v2[5] = CHIRP_VERSION_2;
+    sender.SendBroadcast(asm_msg_v2.data(), asm_msg_v2.size());
+    manager.EnableProtocolV2();
+    sender.SendBroadcast(asm_msg_v2.data(), asm_msg_v2.size());
+    sender.SendBroadcast(asm_msg_valid.data(), asm_msg_valid.size() - 1);
+    sender.SendBroadcast(asm_msg_valid.data(), asm_msg_valid.size());
+    std::this_thread::sleep_for(5ms);
+#ifdef __linux__
+    fails += manager.GetRecvStats().filter_drops == 4 ? 0 : 1;
+#endif
+    fails += manager.GetDiscoveredServices().size() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_recv_threads() {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.Start(4);
+
+    // Send broadcast OFFERs from many hosts, spread over all receive threads
+    for (int n = 0; n < 16; ++n) {
+        const auto asm_msg = Message(OFFER, "group1", "sat" + std::to_string(n + 2), CONTROL, 23999).Assemble();
+        sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    }
+    std::this_thread::sleep_for(5ms);
+
+    int fails = 0;
+    // Test that each service was discovered
+    fails += manager.GetDiscoveredServices().size() == 16 ? 0 : 1;
+    // Send unicast DEPART, test that it is received as well
+    BroadcastSend sender_unicast {"0.0.0.0"};
+    const auto asm_msg = Message(DEPART, "group1", "sat2", CONTROL, 23999).Assemble();
+    sender_unicast.SendBroadcast(asm_msg.data(), asm_msg.size());
+    std::this_thread::sleep_for(5ms);
+    fails += manager.GetDiscoveredServices().size() == 15 ? 0 : 1;
+    // Test that manager can be restarted with single thread
+    manager.Start();
+    const auto asm_msg_offer = Message(OFFER, "group1", "sat2", CONTROL, 23999).Assemble();
+    sender.SendBroadcast(asm_msg_offer.data(), asm_msg_offer.size());
+    std::this_thread::sleep_for(5ms);
+    fails += manager.GetDiscoveredServices().size() == 16 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_recv_stats() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    manager.SetReceiveBufferSize(65536);
+    manager.SetSendBufferSize(65536);
+    manager.Start();
+
+    // Send oversized message
+    const std::array<std::uint8_t, CHIRP_V2_MAX_MESSAGE_LENGTH + 1> oversized_msg {};
+    sender.SendBroadcast(oversized_msg.data(), oversized_msg.size());
+    std::this_thread::sleep_for(5ms);
+
+    int fails = 0;
+    // Test that oversized message was rejected
+    fails += manager.GetRecvStats().oversized == 1 ? 0 : 1;
+
+    // Test that statistics and settings can be accessed while restarting replaces the receivers
+    std::atomic_bool stop {false};
+    std::thread poller {[&]() {
+        while (!stop.load()) {
+            manager.GetRecvStats();
+            manager.SetReceiveBufferSize(65536);
+        }
+    }};
+    for (std::size_t n = 0; n < 20; ++n) {
+        manager.Start(1 + n % 2);
+    }
+    stop.store(true);
+    poller.join();
+    fails += manager.GetRecvStats().oversized == 0 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_latency_stats() {
+    BroadcastSend sender {"0.0.0.0"};
+    Manager manager {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    const auto timestamps = manager.EnableTimestamps();
+    manager.Start();
+
+    // Register callback to record dispatch delay
+    auto callback = [](DiscoveredService /*service*/, bool /*depart*/, std::any /*user_data*/) {};
+    manager.RegisterDiscoverCallback(callback, CONTROL, nullptr);
+
+    // Send OFFER
+    const auto asm_msg = Message(OFFER, "group1", "sat2", CONTROL, 23999).Assemble();
+    sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    std::this_thread::sleep_for(5ms);
+
+    int fails = 0;
+    auto stats = manager.GetLatencyStats();
+    // Test that dispatch delay was recorded
+    fails += stats.dispatch.count == 1 ? 0 : 1;
+    fails += stats.dispatch.max >= stats.dispatch.mean() ? 0 : 1;
+    // Test that queue delay was recorded if timestamps are supported
+    fails += stats.queue.count == (timestamps ? 1 : 0) ? 0 : 1;
+    // Test that statistics can be reset
+    manager.ResetLatencyStats();
+    stats = manager.GetLatencyStats();
+    fails += stats.dispatch.count == 0 && stats.queue.count == 0 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_multicast() {
+    try {
+        Manager manager1 {"239.192.7.123", "group1", "sat1"};
+        Manager manager2 {"239.192.7.123", "group1", "sat2"};
+        manager2.Start();
+
+        // Register service, test that it is discovered via multicast
+        manager1.RegisterService(CONTROL, 23999);
+        std::this_thread::sleep_for(5ms);
+        return manager2.GetDiscoveredServices().size() == 1 ? 0 : 1;
+    }
+    catch (const asio::system_error&) {
+        // No multicast route available
+        return 0;
+    }
+}
+
+int test_manager_discover_events() {
+    asio::io_context io_context {};
+    std::vector<DiscoverEvent> events {};
+    bool closed = false;
+    {
+        Manager manager1 {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+        Manager manager2 {"0.0.0.0", "0.0.0.0", "group1", "sat2"};
+        auto stream = manager2.SubscribeDiscoverEvents(io_context.get_executor());
+        manager2.Start();
+
+        asio::co_spawn(
+            io_context,
+            [&events, &closed, stream]() -> asio::awaitable<void> {
+                // Await events until stream is closed
+                while (auto event = co_await stream->Next()) {
+                    events.push_back(std::move(event.value()));
+                }
+                closed = true;
+            },
+            asio::detached);
+
+        // Register and unregister service
+        manager1.RegisterService(CONTROL, 23999);
+        std::this_thread::sleep_for(5ms);
+        io_context.run_for(5ms);
+        manager1.UnregisterService(CONTROL, 23999);
+        std::this_thread::sleep_for(5ms);
+    }
+    // Destructing manager closes stream
+    io_context.run_for(5ms);
+
+    int fails = 0;
+    fails += events.size() == 2 ? 0 : 1;
+    fails += events.size() == 2 && !events[0].depart && events[1].depart ? 0 : 1;
+    fails += events.size() == 2 && events[0].service.port == 23999 ? 0 : 1;
+    fails += closed ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_io_uring() {
+    Manager manager1 {"0.0.0.0", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"0.0.0.0", "0.0.0.0", "group1", "sat2"};
+    manager2.Start();
+    if (!manager2.EnableIoUring()) {
+        // io_uring not supported on this platform or build
+        return 0;
+    }
+
+    int fails = 0;
+    // Register service, test that it is discovered by the restarted receive thread
+    manager1.RegisterService(CONTROL, 23999);
+    std::this_thread::sleep_for(5ms);
+    fails += manager2.GetDiscoveredServices().size() == 1 ? 0 : 1;
+    // Test that receivers opened by Start also use io_uring
+    manager2.Start(2);
+    manager1.RegisterService(DATA, 24000);
+    std::this_thread::sleep_for(5ms);
+    fails += manager2.GetDiscoveredServices().size() == 2 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_bulk_register() {
+    // Broadcast such that both managers receive the REQUEST
+    Manager manager1 {"127.255.255.255", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.Start();
+    manager2.Start();
+
+    // Register more services than sent in one batch, including a duplicate
+    std::vector<RegisteredService> services {};
+    for (Port port = 0; port < 100; ++port) {
+        services.push_back({CONTROL, static_cast<Port>(23000 + port)});
+    }
+    services.push_back({CONTROL, 23000});
+
+    int fails = 0;
+    fails += manager1.RegisterServices(services) == 100 ? 0 : 1;
+    fails += manager1.RegisterServices(services) == 0 ? 0 : 1;
+    std::this_thread::sleep_for(10ms);
+    fails += manager2.GetDiscoveredServices().size() == 100 ? 0 : 1;
+
+    // Test that REQUEST is answered with OFFERs for all services
+    manager2.ForgetDiscoveredServices();
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(10ms);
+    fails += manager2.GetDiscoveredServices().size() == 100 ? 0 : 1;
+
+    // Unregister half of the services
+    fails += manager1.UnregisterServices(std::span(services).first(50)) == 50 ? 0 : 1;
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.GetRegisteredServices().size() == 50 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().size() == 50 ? 0 : 1;
+
+    // Unregister remaining services
+    manager1.UnregisterServices();
+    std::this_thread::sleep_for(10ms);
+    fails += manager2.GetDiscoveredServices().empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_reply_coalescing() {
+    // Broadcast such that both managers receive the REQUEST
+    Manager manager1 {"127.255.255.255", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.SetReplyJitter(20ms);
+    manager1.SetReplyHoldOff(500ms);
+    manager1.RegisterService(CONTROL, 23999);
+    manager1.Start();
+    manager2.Start();
+
+    int fails = 0;
+    // Test that REQUESTs within the jitter are answered by a single reply round
+    manager2.SendRequest(CONTROL);
+    manager2.SendRequest(CONTROL);
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(50ms);
+    const auto stats = manager1.GetReplyStats();
+    fails += stats.requests == 3 ? 0 : 1;
+    fails += stats.replies == 1 ? 0 : 1;
+    fails += stats.coalesced == 2 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().size() == 1 ? 0 : 1;
+
+    // Test that REQUEST shortly after the reply round is not answered
+    manager2.ForgetDiscoveredServices();
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(50ms);
+    fails += manager1.GetReplyStats().suppressed == 1 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().empty() ? 0 : 1;
+
+    // Test that REQUEST for other service identifier is answered independently
+    manager1.RegisterService(HEARTBEAT, 24000);
+    manager2.ForgetDiscoveredServices();
+    manager2.SendRequest(HEARTBEAT);
+    std::this_thread::sleep_for(50ms);
+    fails += manager1.GetReplyStats().replies == 2 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices(HEARTBEAT).size() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_send_queue() {
+    // Broadcast such that both managers receive the OFFERs
+    auto manager1 = std::make_unique<Manager>("127.255.255.255", "0.0.0.0", "group1", "sat1");
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager2.SetReceiveBufferSize(1024 * 1024);
+    manager2.Start();
+
+    // Register more services than fit in the send queue
+    std::vector<RegisteredService> services {};
+    for (Port port = 0; port < 2000; ++port) {
+        services.push_back({DATA, static_cast<Port>(23000 + port)});
+    }
+
+    int fails = 0;
+    fails += manager1->RegisterServices(services) == 2000 ? 0 : 1;
+    std::this_thread::sleep_for(50ms);
+    // Test that OFFERs not fitting in the send queue are dropped and reported instead of blocking
+    const auto stats = manager1->GetSendStats();
+    fails += stats.queued + stats.dropped == 2000 ? 0 : 1;
+    fails += stats.sent == stats.queued ? 0 : 1;
+    fails += stats.failed == 0 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices(DATA).size() == stats.queued ? 0 : 1;
+
+    // Test that DEPARTs not fitting in the send queue are kept instead of dropped
+    fails += manager1->UnregisterServices(std::span(services).first(1500)) == 1500 ? 0 : 1;
+    std::this_thread::sleep_for(50ms);
+    const auto stats_depart = manager1->GetSendStats();
+    fails += stats_depart.dropped == stats.dropped ? 0 : 1;
+    fails += stats_depart.queued == stats.queued + 1500 ? 0 : 1;
+    fails += stats_depart.sent == stats_depart.queued ? 0 : 1;
+
+    // Test that queued DEPARTs are sent before destruction completes
+    manager1.reset();
+    std::this_thread::sleep_for(50ms);
+    fails += manager2.GetDiscoveredServices().empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_interfaces() {
+    // Test that enumerated interfaces are usable
+    auto interfaces = GetNetworkInterfaces();
+    int fails = 0;
+    for (const auto& network_interface : interfaces) {
+        fails += network_interface.index > 0 && network_interface.broadcast_address.is_v4() ? 0 : 1;
+    }
+#ifdef __linux__
+    // Loopback interface does not support broadcasts, add it manually
+    const NetworkInterface loopback {"lo", ::if_nametoindex("lo"), asio::ip::make_address("127.0.0.1"), asio::ip::make_address("127.255.255.255")};
+    interfaces.push_back(loopback);
+
+    // Test that OFFERs are sent on all interfaces
+    BroadcastRecv receiver {"0.0.0.0"};
+    receiver.EnablePacketInfo();
+    Manager manager1 {interfaces, "group1", "sat1"};
+    manager1.RegisterService(CONTROL, 23999);
+    std::array<BroadcastMessage, 8> messages {};
+    std::this_thread::sleep_for(10ms);
+    const auto count = receiver.AsyncRecvBroadcasts(messages, 10ms);
+    fails += count == interfaces.size() ? 0 : 1;
+    for (std::size_t n = 0; n < count; ++n) {
+        fails += std::ranges::count(interfaces, messages[n].interface_index, &NetworkInterface::index) == 1 ? 0 : 1;
+    }
+    // Test that broadcasts are counted once regardless of the number of interfaces
+    const auto stats = manager1.GetSendStats();
+    fails += stats.queued == 1 && stats.sent == 1 && stats.failed == 0 ? 0 : 1;
+
+    // Test that the interface of discovered services is recorded
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.Start();
+    manager2.RegisterService(DATA, 24000);
+    std::this_thread::sleep_for(10ms);
+    const auto services = manager1.GetDiscoveredServices();
+    fails += services.size() == 1 ? 0 : 1;
+    fails += !services.empty() && services[0].interface_index == loopback.index ? 0 : 1;
+
+    // Test that broadcasts on other interfaces are ignored
+    interfaces.pop_back();
+    if (!interfaces.empty()) {
+        Manager manager3 {interfaces, "group1", "sat3"};
+        manager3.Start();
+        manager2.RegisterService(DATA, 24001);
+        std::this_thread::sleep_for(10ms);
+        fails += manager3.GetDiscoveredServices().empty() ? 0 : 1;
+    }
+#endif
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_protocol_v2() {
+    // Broadcast such that both managers receive the messages
+    Manager manager1 {"127.255.255.255", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.EnableProtocolV2();
+    manager2.EnableProtocolV2();
+    manager1.Start();
+    manager2.Start();
+
+    // Test that CHIRP v2 is negotiated via REQUESTs
+    int fails = 0;
+    fails += manager1.UsesProtocolV2() ? 1 : 0;
+    manager1.SendRequest(CONTROL);
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() && manager2.UsesProtocolV2() ? 0 : 1;
+
+    // Test that OFFERs are packed into a single broadcast
+    const std::array<RegisteredService, 3> services {{{CONTROL, 23999}, {HEARTBEAT, 24000}, {DATA, 24001}}};
+    const auto queued = manager1.GetSendStats().queued;
+    fails += manager1.RegisterServices(services) == 3 ? 0 : 1;
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.GetSendStats().queued == queued + 1 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().size() == 3 ? 0 : 1;
+
+    // Test that a REQUEST is answered with all services in a single broadcast
+    manager2.ForgetDiscoveredServices();
+    manager2.SendRequest(DATA);
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.GetSendStats().queued == queued + 2 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().size() == 3 ? 0 : 1;
+
+    // Test that DEPARTs are packed as well
+    manager1.UnregisterServices();
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.GetSendStats().queued == queued + 3 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().empty() ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_protocol_v2_fallback() {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager1 {"127.255.255.255", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.EnableProtocolV2();
+    manager1.Start();
+    manager2.Start();
+
+    // Test that a host only supporting CHIRP v1 prevents CHIRP v2
+    int fails = 0;
+    manager1.SendRequest(CONTROL);
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() ? 1 : 0;
+    const std::array<RegisteredService, 2> services {{{CONTROL, 23999}, {DATA, 24000}}};
+    manager1.RegisterServices(services);
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.GetSendStats().queued == 3 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices().size() == 2 ? 0 : 1;
+
+    // Test that CHIRP v2 messages are decoded without enabling CHIRP v2
+    MultiMessage multi_msg {OFFER, "group1", "sat3"};
+    multi_msg.AddService(CONTROL, 25000);
+    multi_msg.AddService(MONITORING, 25001);
+    const auto asm_msg = multi_msg.Assemble();
+    sender.SendBroadcast(asm_msg.data(), asm_msg.size());
+    std::this_thread::sleep_for(10ms);
+    fails += manager2.GetDiscoveredServices().size() == 4 ? 0 : 1;
+    fails += manager2.GetDiscoveredServices(MONITORING).size() == 1 ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_manager_protocol_v2_peers() {
+    BroadcastSend sender {"127.255.255.255"};
+    Manager manager1 {"127.255.255.255", "0.0.0.0", "group1", "sat1"};
+    Manager manager2 {"127.255.255.255", "0.0.0.0", "group1", "sat2"};
+    manager1.EnableProtocolV2();
+    manager2.EnableProtocolV2();
+    manager1.Start();
+    manager2.Start();
+
+    int fails = 0;
+    manager1.SendRequest(CONTROL);
+    manager2.SendRequest(CONTROL);
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() ? 0 : 1;
+
+    // Test that a host only supporting CHIRP v1 prevents CHIRP v2 until its last service departed
+    const auto asm_msg_offer = Message(OFFER, "group1", "sat3", DATA, 24000).Assemble();
+    const auto asm_msg_depart = Message(DEPART, "group1", "sat3", DATA, 24000).Assemble();
+    sender.SendBroadcast(asm_msg_offer.data(), asm_msg_offer.size());
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() ? 1 : 0;
+    sender.SendBroadcast(asm_msg_depart.data(), asm_msg_depart.size());
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() ? 0 : 1;
+
+    // Test that only the exact version is accepted as announcement of CHIRP v2
+    const auto asm_msg_request = Message(REQUEST, "group1", "sat3", CONTROL, CHIRP_VERSION_2 + 1).Assemble();
+    sender.SendBroadcast(asm_msg_request.data(), asm_msg_request.size());
+    std::this_thread::sleep_for(10ms);
+    fails += manager1.UsesProtocolV2() ? 1 : 0;
+    return fails == 0 ? 0 : 1;
+}
+
 int main() {
     int ret = 0;
     int ret_test = 0;
@@ -344,6 +1556,18 @@ int main() {
     std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
     ret += ret_test;
 
+    // test_manager_hash_services
+    std::cout << "test_manager_hash_services...                " << std::flush;
+    ret_test = test_manager_hash_services();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discovered_service_table
+    std::cout << "test_manager_discovered_service_table...     " << std::flush;
+    ret_test = test_manager_discovered_service_table();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
     // test_manager_sort_discover_callback_entry
     std::cout << "test_manager_sort_discover_callback_entry... " << std::flush;
     ret_test = test_manager_sort_discover_callback_entry();
@@ -410,6 +1634,168 @@ int main() {
     std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
     ret += ret_test;
 
+    // test_manager_steady_state_allocations
+    std::cout << "test_manager_steady_state_allocations...     " << std::flush;
+    ret_test = test_manager_steady_state_allocations();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_stop_latency
+    std::cout << "test_manager_stop_latency...                 " << std::flush;
+    ret_test = test_manager_stop_latency();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_kernel_filter
+    std::cout << "test_manager_kernel_filter...                " << std::flush;
+    ret_test = test_manager_kernel_filter();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_recv_threads
+    std::cout << "test_manager_recv_threads...                 " << std::flush;
+    ret_test = test_manager_recv_threads();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_recv_stats
+    std::cout << "test_manager_recv_stats...                   " << std::flush;
+    ret_test = test_manager_recv_stats();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_latency_stats
+    std::cout << "test_manager_latency_stats...                " << std::flush;
+    ret_test = test_manager_latency_stats();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_multicast
+    std::cout << "test_manager_multicast...                    " << std::flush;
+    ret_test = test_manager_multicast();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discover_events
+    std::cout << "test_manager_discover_events...              " << std::flush;
+    ret_test = test_manager_discover_events();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_io_uring
+    std::cout << "test_manager_io_uring...                     " << std::flush;
+    ret_test = test_manager_io_uring();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_bulk_register
+    std::cout << "test_manager_bulk_register...                " << std::flush;
+    ret_test = test_manager_bulk_register();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_reply_coalescing
+    std::cout << "test_manager_reply_coalescing...             " << std::flush;
+    ret_test = test_manager_reply_coalescing();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_send_queue
+    std::cout << "test_manager_send_queue...                   " << std::flush;
+    ret_test = test_manager_send_queue();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_interfaces
+    std::cout << "test_manager_interfaces...                   " << std::flush;
+    ret_test = test_manager_interfaces();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_protocol_v2
+    std::cout << "test_manager_protocol_v2...                  " << std::flush;
+    ret_test = test_manager_protocol_v2();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_protocol_v2_fallback
+    std::cout << "test_manager_protocol_v2_fallback...         " << std::flush;
+    ret_test = test_manager_protocol_v2_fallback();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_protocol_v2_peers
+    std::cout << "test_manager_protocol_v2_peers...            " << std::flush;
+    ret_test = test_manager_protocol_v2_peers();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discovered_services_snapshot
+    std::cout << "test_manager_discovered_services_snapshot... " << std::flush;
+    ret_test = test_manager_discovered_services_snapshot();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discovered_service_changes
+    std::cout << "test_manager_discovered_service_changes...   " << std::flush;
+    ret_test = test_manager_discovered_service_changes();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discovered_service_feed
+    std::cout << "test_manager_discovered_service_feed...      " << std::flush;
+    ret_test = test_manager_discovered_service_feed();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_callback_threads
+    std::cout << "test_manager_callback_threads...             " << std::flush;
+    ret_test = test_manager_callback_threads();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_callback_unregister_full
+    std::cout << "test_manager_callback_unregister_full...     " << std::flush;
+    ret_test = test_manager_callback_unregister_full();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_callback_queue_full
+    std::cout << "test_manager_callback_queue_full...          " << std::flush;
+    ret_test = test_manager_callback_queue_full();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_batch_callbacks
+    std::cout << "test_manager_batch_callbacks...              " << std::flush;
+    ret_test = test_manager_batch_callbacks();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_timing_wheel
+    std::cout << "test_manager_timing_wheel...                 " << std::flush;
+    ret_test = test_manager_timing_wheel();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_discovered_service_expiry
+    std::cout << "test_manager_discovered_service_expiry...    " << std::flush;
+    ret_test = test_manager_discovered_service_expiry();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_service_ttl
+    std::cout << "test_manager_service_ttl...                  " << std::flush;
+    ret_test = test_manager_service_ttl();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_manager_service_ttl_race
+    std::cout << "test_manager_service_ttl_race...             " << std::flush;
+    ret_test = test_manager_service_ttl_race();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
     if (ret == 0) {
         std::cout << "\nAll tests passed" << std::endl;
     }
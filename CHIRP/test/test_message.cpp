@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <array>
+#include <compare>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <span>
+#include <string>
+#include <variant>
 #include <vector>
 
 #include "CHIRP/exceptions.hpp"
@@ -8,6 +14,47 @@
 
 using namespace cnstln::CHIRP;
 
+// Compile-time assembled and decoded messages
+constexpr auto CONSTEXPR_ASM_MSG = Message(OFFER, "group", "host", DATA, 47890).Assemble();
+constexpr MessageView CONSTEXPR_VIEW {CONSTEXPR_ASM_MSG};
+static_assert(CONSTEXPR_VIEW.IsValid());
+static_assert(CONSTEXPR_VIEW.GetType() == OFFER);
+static_assert(CONSTEXPR_VIEW.HasGroupID(MD5Hash("group")));
+static_assert(!CONSTEXPR_VIEW.HasGroupID(MD5Hash("host")));
+static_assert(CONSTEXPR_VIEW.HasHostID(MD5Hash("host")));
+static_assert(MD5Hash(CONSTEXPR_VIEW.GetHostID()) == MD5Hash("host"));
+static_assert(CONSTEXPR_VIEW.GetServiceIdentifier() == DATA);
+static_assert(CONSTEXPR_VIEW.GetPort() == 47890);
+// Compile-time MD5 hash matches RFC 1321 test value
+static_assert(MD5Hash("abc") == MD5Hash(std::array<std::uint8_t, 16> {0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0,
+                                                                       0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72}));
+// Invalid messages are detected
+constexpr bool constexpr_view_valid(std::size_t index, std::uint8_t value) {
+    auto asm_msg = CONSTEXPR_ASM_MSG;
+    asm_msg[index] = value;
+    return MessageView(asm_msg).IsValid();
+}
+static_assert(!constexpr_view_valid(0, 'X'));
+static_assert(!constexpr_view_valid(5, CHIRP_VERSION + 1));
+static_assert(!constexpr_view_valid(6, 0));
+static_assert(!constexpr_view_valid(39, 5));
+// Compile-time decoding without exceptions
+static_assert(Message::TryDecode(CONSTEXPR_ASM_MSG).has_value());
+static_assert(Message::TryDecode(CONSTEXPR_ASM_MSG)->GetPort() == 47890);
+static_assert(Message::TryDecode(std::span(CONSTEXPR_ASM_MSG).first(41)).error() == DecodeErrorCode::INVALID_LENGTH);
+// Compile-time assembled CHIRP v2 message with multiple services
+constexpr auto CONSTEXPR_ASM_MULTI_MSG = [] {
+    MultiMessage multi_msg {OFFER, "group", "host"};
+    multi_msg.AddService(CONTROL, 23999);
+    multi_msg.AddService(DATA, 47890);
+    return multi_msg.Assemble();
+}();
+static_assert(CONSTEXPR_ASM_MULTI_MSG.size() == CHIRP_V2_HEADER_LENGTH + 2 * CHIRP_V2_SERVICE_LENGTH);
+static_assert(MultiMessageView(CONSTEXPR_ASM_MULTI_MSG).IsValid());
+static_assert(MultiMessageView(CONSTEXPR_ASM_MULTI_MSG).GetServiceCount() == 2);
+static_assert(MultiMessageView(CONSTEXPR_ASM_MULTI_MSG).GetServiceIdentifier(1) == DATA);
+static_assert(MultiMessageView(CONSTEXPR_ASM_MULTI_MSG).GetPort(1) == 47890);
+
 int test_message_md5_hash() {
     int fails = 0;
     // Test values from RFC 1321 reference implementation
@@ -25,6 +72,36 @@ int test_message_md5_sort() {
     int fails = 0;
     fails += MD5Hash("a") < MD5Hash("a") ? 1 : 0;
     fails += MD5Hash("a") < MD5Hash("b") ? 0 : 1;
+
+    // Test that later bytes do not matter if earlier bytes differ
+    std::array<std::uint8_t, 16> bytes_s {};
+    std::array<std::uint8_t, 16> bytes_l {};
+    bytes_s[0] = 0x01;
+    bytes_s[1] = 0xFF;
+    bytes_l[0] = 0x02;
+    fails += MD5Hash(bytes_s) < MD5Hash(bytes_l) ? 0 : 1;
+    fails += MD5Hash(bytes_l) < MD5Hash(bytes_s) ? 1 : 0;
+    // Test that the lower word is compared if the upper word is equal
+    bytes_l = bytes_s;
+    bytes_s[15] = 0x01;
+    bytes_l[15] = 0x02;
+    bytes_s[14] = 0xFF;
+    bytes_l[14] = 0xFF;
+    fails += MD5Hash(bytes_s) < MD5Hash(bytes_l) ? 0 : 1;
+    fails += MD5Hash(bytes_l) < MD5Hash(bytes_s) ? 1 : 0;
+    fails += std::is_eq(MD5Hash(bytes_s) <=> MD5Hash(bytes_s)) ? 0 : 1;
+
+    // Test that the order matches the lexicographical order of the bytes
+    std::vector<MD5Hash> hashes {};
+    for (int n = 0; n < 64; ++n) {
+        hashes.emplace_back(std::to_string(n));
+    }
+    for (const auto& hash_a : hashes) {
+        for (const auto& hash_b : hashes) {
+            const bool lexicographical = std::ranges::lexicographical_compare(hash_a, hash_b);
+            fails += (hash_a < hash_b) == lexicographical ? 0 : 1;
+        }
+    }
     return fails == 0 ? 0 : 1;
 }
 
@@ -106,6 +183,108 @@ int test_message_construct_invalid_service() {
     return ret;
 }
 
+int test_message_view() {
+    // Test that view decodes the same fields as the message, also for messages assembled at runtime
+    const auto msg = Message(DEPART, "group", "host", HEARTBEAT, 1234);
+    const auto asm_msg = msg.Assemble();
+    const MessageView view {asm_msg};
+    int fails = 0;
+    fails += view.IsValid() ? 0 : 1;
+    fails += view.GetType() == msg.GetType() ? 0 : 1;
+    fails += view.HasGroupID(msg.GetGroupID()) ? 0 : 1;
+    fails += view.HasHostID(msg.GetHostID()) ? 0 : 1;
+    fails += view.GetServiceIdentifier() == msg.GetServiceIdentifier() ? 0 : 1;
+    fails += view.GetPort() == msg.GetPort() ? 0 : 1;
+    // Test that compile-time and runtime assembly agree
+    fails += Message(OFFER, "group", "host", DATA, 47890).Assemble() == CONSTEXPR_ASM_MSG ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
+int test_message_try_decode() {
+    const auto asm_msg = Message(OFFER, "group", "host", CONTROL, 47890).Assemble();
+    int fails = 0;
+    // Test successful decoding from bytes of arbitrary container
+    const std::vector<std::uint8_t> msg_data {asm_msg.cbegin(), asm_msg.cend()};
+    const auto result = Message::TryDecode(msg_data);
+    fails += result.has_value() ? 0 : 1;
+    fails += result && result->GetHostID() == MD5Hash("host") ? 0 : 1;
+    fails += result && (*result).GetPort() == 47890 ? 0 : 1;
+
+    // Test error codes for malformed messages
+    auto invalid_msg = asm_msg;
+    invalid_msg[5] = CHIRP_VERSION + 1;
+    fails += Message::TryDecode(invalid_msg).error() == DecodeErrorCode::INVALID_HEADER ? 0 : 1;
+    invalid_msg = asm_msg;
+    invalid_msg[6] = 255;
+    fails += Message::TryDecode(invalid_msg).error() == DecodeErrorCode::INVALID_TYPE ? 0 : 1;
+    invalid_msg = asm_msg;
+    invalid_msg[39] = 0;
+    fails += Message::TryDecode(invalid_msg).error() == DecodeErrorCode::INVALID_SERVICE ? 0 : 1;
+    fails += Message::TryDecode(std::span(msg_data).first(CHIRP_MESSAGE_LENGTH - 1)).error() == DecodeErrorCode::INVALID_LENGTH ? 0 : 1;
+
+    // Test that accessing the value of a failed result throws
+    try {
+        const auto failed = Message::TryDecode(invalid_msg);
+        static_cast<void>(failed.value());
+        fails += 1;
+    }
+    catch (const std::bad_variant_access&) {
+    }
+    return fails == 0 ? 0 : 1;
+}
+
+int test_message_multi() {
+    MultiMessage multi_msg {DEPART, "group", "host"};
+    multi_msg.AddService(CONTROL, 23999);
+    multi_msg.AddService(HEARTBEAT, 24000);
+    multi_msg.AddService(MONITORING, 65535);
+    const auto asm_msg = multi_msg.Assemble();
+    const std::vector<std::uint8_t> msg_data {asm_msg.begin(), asm_msg.end()};
+
+    int fails = 0;
+    // Test decoding of all services
+    const MultiMessageView view {msg_data};
+    fails += view.IsValid() ? 0 : 1;
+    fails += view.GetType() == DEPART ? 0 : 1;
+    fails += view.HasGroupID(MD5Hash("group")) && view.HasHostID(MD5Hash("host")) ? 0 : 1;
+    fails += view.GetServiceCount() == 3 ? 0 : 1;
+    const MultiMessage reconstructed {view};
+    for (std::size_t n = 0; n < 3; ++n) {
+        const auto msg = multi_msg.GetMessage(n);
+        const auto reconstructed_msg = reconstructed.GetMessage(n);
+        fails += reconstructed_msg.GetType() == msg.GetType() ? 0 : 1;
+        fails += reconstructed_msg.GetHostID() == msg.GetHostID() ? 0 : 1;
+        fails += reconstructed_msg.GetServiceIdentifier() == msg.GetServiceIdentifier() ? 0 : 1;
+        fails += reconstructed_msg.GetPort() == msg.GetPort() ? 0 : 1;
+    }
+
+    // Test error codes for malformed messages
+    fails += MultiMessageView(std::span(msg_data).first(msg_data.size() - 1)).Validate() == DecodeErrorCode::INVALID_LENGTH ? 0 : 1;
+    auto invalid_msg = msg_data;
+    invalid_msg[MultiMessageView::SERVICE_COUNT_OFFSET] = 4;
+    fails += MultiMessageView(invalid_msg).Validate() == DecodeErrorCode::INVALID_LENGTH ? 0 : 1;
+    invalid_msg = msg_data;
+    invalid_msg[5] = CHIRP_VERSION;
+    fails += MultiMessageView(invalid_msg).Validate() == DecodeErrorCode::INVALID_HEADER ? 0 : 1;
+    invalid_msg = msg_data;
+    invalid_msg[CHIRP_V2_HEADER_LENGTH + 2 * CHIRP_V2_SERVICE_LENGTH] = 0;
+    fails += MultiMessageView(invalid_msg).Validate() == DecodeErrorCode::INVALID_SERVICE ? 0 : 1;
+
+    // Test that CHIRP v1 and CHIRP v2 messages are not confused
+    const auto asm_msg_v1 = Message(OFFER, "group", "host", CONTROL, 23999).Assemble();
+    fails += MultiMessageView(asm_msg_v1).IsValid() ? 1 : 0;
+    fails += Message::TryDecode(msg_data).has_value() ? 1 : 0;
+
+    // Test that messages are limited to the maximum number of services
+    MultiMessage full_msg {OFFER, "group", "host"};
+    for (std::size_t n = 0; n < CHIRP_V2_MAX_SERVICES; ++n) {
+        fails += full_msg.AddService(DATA, static_cast<Port>(n)) ? 0 : 1;
+    }
+    fails += full_msg.AddService(DATA, 0) ? 1 : 0;
+    fails += full_msg.Assemble().size() == CHIRP_V2_MAX_MESSAGE_LENGTH ? 0 : 1;
+    return fails == 0 ? 0 : 1;
+}
+
 int main() {
     int ret = 0;
     int ret_test = 0;
@@ -152,6 +331,24 @@ int main() {
     std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
     ret += ret_test;
 
+    // test_message_view
+    std::cout << "test_message_view...                         " << std::flush;
+    ret_test = test_message_view();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_message_try_decode
+    std::cout << "test_message_try_decode...                   " << std::flush;
+    ret_test = test_message_try_decode();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
+    // test_message_multi
+    std::cout << "test_message_multi...                        " << std::flush;
+    ret_test = test_message_multi();
+    std::cout << (ret_test == 0 ? " passed" : " failed") << std::endl;
+    ret += ret_test;
+
     if (ret == 0) {
         std::cout << "\nAll tests passed" << std::endl;
     }